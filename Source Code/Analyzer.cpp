@@ -0,0 +1,703 @@
+/*-----------------------------------------------------------------------------------
+--	SOURCE FILE:	Analyzer.cpp - Protocol analyzer of the terminal emulator,
+--								   timestamping every received byte and splitting
+--								   the stream into frames on line silences.
+--
+--	PROGRAM:        Terminal Emulator
+--
+--	FUNCTIONS:
+--					void InitAnalyzer()
+--					void PrintTimeline()
+--					LONGLONG TicksToMicros(LONGLONG ticks)
+--					DWORD AnalyzeInput()
+--					void ShowGapHistogram()
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - reads into a pooled receive buffer
+--					October 19, 2026 - the counter frequency is read once at
+--									   startup and shared with framing
+--					October 19, 2026 - the timeline is printed by the window
+--									   thread, not the timestamping thread
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	NOTES:			Analyzer.cpp is part of a minimal Windows terminal emulator,
+--					that transmits characters typed on the keyboard to the serial
+--					port and displays all characters received via the serial port.
+--
+--					In analyzer mode the read thread waits on comm events instead
+--					of reads, and drains the driver queue as soon as EV_RXCHAR is
+--					signalled, stamping the batch with the performance counter.
+--					Bytes in a batch arrived back to back, so each is stamped one
+--					character time before the one after it.  The accuracy is that
+--					of the driver's notification, which on a native UART is well
+--					under a millisecond but on a USB adapter is bounded by its
+--					latency timer.
+--
+--					A silence of 3.5 character times (1.75 ms above 19200 baud, as
+--					in Modbus RTU) ends a frame.  Each frame is printed as one line
+--					of the timeline, and every silence between two bytes goes into
+--					a histogram of power of two microsecond buckets.
+--
+--					The read thread only waits, reads, stamps and finds gaps; it
+--					never formats text or waits on screenLock, which the window
+--					thread holds while painting.  Finished frames and line events
+--					go into a ring carved out of the session arena at startup, and
+--					the window thread is posted WM_TIMELINE to print them.  If the
+--					window falls a whole ring behind, entries are counted and
+--					dropped rather than delaying the timestamps.
+--
+--					This layer belongs with the Physical layer: it owns the port
+--					while the session is connected in analyzer mode.
+-----------------------------------------------------------------------------------*/
+
+#define STRICT
+
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "header.h"
+
+#define ANALYZER_QUEUE        65536   // driver receive queue, bytes
+#define ANALYZER_SHOWN_BYTES  64      // bytes of a frame printed in hex
+#define GAP_BUCKETS           20      // histogram buckets, 2^(i+3) us wide
+#define MODBUS_FAST_BAUD      19200   // above this the frame gap is fixed
+#define MODBUS_FAST_GAP_US    1750
+#define TIMELINE_ENTRIES      4096    // frames and events awaiting the window, a power of two
+#define TIMELINE_LINE_MAX     (96 + ANALYZER_SHOWN_BYTES * 3)
+#define TIMELINE_LISTING_SIZE 65536   // lines printed by one WM_TIMELINE
+
+// What a timeline entry records
+typedef enum {
+	TIMELINE_FRAME,
+	TIMELINE_BREAK,
+	TIMELINE_ERROR
+} TIMELINEKIND;
+
+// A frame or line event handed from the read thread to the window thread
+typedef struct {
+	TIMELINEKIND kind;
+	DWORD length;                               // bytes in a frame
+	DWORD errors;                               // CE_ flags of an error
+	LONGLONG when;                              // ticks since the session started
+	LONGLONG gap;                               // silence before a frame, ticks
+	LONGLONG maxGap;                            // longest silence inside a frame, ticks
+	BYTE bytes[ANALYZER_SHOWN_BYTES];
+} TIMELINEENTRY;
+
+// declared variables
+BOOL analyzerEnabled = FALSE;
+static LONGLONG frequency;                      // performance counter ticks per second, set at startup
+static LONGLONG charTicks;                      // ticks to receive one character
+static LONGLONG gapTicks;                       // silence that ends a frame
+static LONGLONG sessionStart;                   // counter at connect
+static LONGLONG lastArrival;                    // counter at the last byte, 0 before any
+static LONGLONG frameStart;                     // counter at the first byte of the frame
+static LONGLONG frameGap;                       // silence before the frame
+static LONGLONG frameMaxGap;                    // longest silence inside the frame
+static DWORD frameLength;                       // bytes in the open frame
+static BYTE frameBytes[ANALYZER_SHOWN_BYTES];
+static DWORD gapHistogram[GAP_BUCKETS];
+static DWORD totalBytes, totalFrames, breakCount, errorCount, overrunCount;
+static TIMELINEENTRY* timeline;                 // ring written by the read thread only
+static volatile LONG timelineHead;              // entries added, by the read thread
+static volatile LONG timelineTail;              // entries printed, by the window thread
+static LONG timelineDropped;                    // entries lost to a full ring
+static LONG timelinePending = 0;                // WM_TIMELINE posted and not handled yet
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: TicksToMicros
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - shared with the framing listing
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		LONGLONG TicksToMicros(LONGLONG ticks)
+--
+--	RETURNS:		LONGLONG - the performance counter interval in microseconds
+--
+--	NOTES:			Splits the conversion so long sessions do not overflow.  Valid
+--					once InitAnalyzer has run.
+-----------------------------------------------------------------------------------*/
+LONGLONG TicksToMicros(LONGLONG ticks) {
+	return (ticks / frequency) * 1000000 + (ticks % frequency) * 1000000 / frequency;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: NextTimelineEntry
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static TIMELINEENTRY* NextTimelineEntry(TIMELINEKIND kind,
+--						LONGLONG when)
+--
+--	RETURNS:		TIMELINEENTRY* - the entry to fill, or NULL if the ring is full
+--
+--	NOTES:			Called by the read thread.  The entry is not seen by the window
+--					thread until AddTimelineEntry.
+-----------------------------------------------------------------------------------*/
+static TIMELINEENTRY* NextTimelineEntry(TIMELINEKIND kind, LONGLONG when) {
+	if ((DWORD)(timelineHead - timelineTail) >= TIMELINE_ENTRIES) {
+		InterlockedIncrement(&timelineDropped);
+		return NULL;
+	}
+
+	TIMELINEENTRY* entry = &timeline[timelineHead & (TIMELINE_ENTRIES - 1)];
+	entry->kind = kind;
+	entry->when = when - sessionStart;
+	return entry;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: AddTimelineEntry
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static void AddTimelineEntry()
+--
+--	RETURNS:		void
+--
+--	NOTES:			Hands the entry filled in since NextTimelineEntry to the window
+--					thread, posting WM_TIMELINE unless one is already waiting.
+-----------------------------------------------------------------------------------*/
+static void AddTimelineEntry() {
+	InterlockedIncrement(&timelineHead); // also orders the entry's contents before it
+	if (InterlockedExchange(&timelinePending, 1) == 0) {
+		PostMessage(hwnd, WM_TIMELINE, 0, 0);
+	}
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: CloseFrame
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - queued for the window thread to print
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static void CloseFrame()
+--
+--	RETURNS:		void
+--
+--	NOTES:			Hands the open frame to the window thread for the timeline: the
+--					silence before it, its length, the longest silence inside it
+--					and its first bytes.
+-----------------------------------------------------------------------------------*/
+static void CloseFrame() {
+	if (frameLength == 0) {
+		return;
+	}
+
+	TIMELINEENTRY* entry = NextTimelineEntry(TIMELINE_FRAME, frameStart);
+	if (entry != NULL) {
+		entry->length = frameLength;
+		entry->gap = frameGap;
+		entry->maxGap = frameMaxGap;
+		memcpy(entry->bytes, frameBytes, min(frameLength, (DWORD)ANALYZER_SHOWN_BYTES));
+		AddTimelineEntry();
+	}
+	totalFrames++;
+	frameLength = 0;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: RecordByte
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static void RecordByte(BYTE b, LONGLONG arrival)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Adds a byte to the histogram and to the open frame, closing the
+--					frame first if the silence before the byte is a frame gap.
+-----------------------------------------------------------------------------------*/
+static void RecordByte(BYTE b, LONGLONG arrival) {
+	LONGLONG silence = 0;
+
+	if (lastArrival != 0) {
+		//the byte started arriving one character time before it ended
+		silence = arrival - charTicks - lastArrival;
+		if (silence < 0) {
+			silence = 0;
+		}
+
+		int bucket = 0;
+		for (LONGLONG us = TicksToMicros(silence) >> 4; us > 0 && bucket < GAP_BUCKETS - 1; us >>= 1) {
+			bucket++;
+		}
+		gapHistogram[bucket]++;
+	}
+
+	if (frameLength > 0 && silence >= gapTicks) {
+		CloseFrame();
+	}
+
+	if (frameLength == 0) {
+		frameStart = arrival;
+		frameGap = silence;
+		frameMaxGap = 0;
+	} else if (silence > frameMaxGap) {
+		frameMaxGap = silence;
+	}
+
+	if (frameLength < ANALYZER_SHOWN_BYTES) {
+		frameBytes[frameLength] = b;
+	}
+	frameLength++;
+	totalBytes++;
+	lastArrival = arrival;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: StartAnalyzer
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static BOOL StartAnalyzer()
+--
+--	RETURNS:		BOOL - FALSE if the port could not be set up for analyzing
+--
+--	NOTES:			Enlarges the driver queue, makes reads return at once with
+--					whatever has arrived, and works out the character time from the
+--					port settings.
+-----------------------------------------------------------------------------------*/
+static BOOL StartAnalyzer() {
+	COMMTIMEOUTS timeouts = { MAXDWORD, 0, 0, 0, 0 };
+	LARGE_INTEGER counter;
+
+	if (!SetupComm(hComm, ANALYZER_QUEUE, ANALYZER_QUEUE)) {
+		OutputDebugString("error enlarging comm queues");
+	}
+	if (!SetCommTimeouts(hComm, &timeouts)) {
+		MessageBox(NULL, "Error setting analyzer timeouts", "", MB_OK);
+		return false;
+	}
+	if (!SetCommMask(hComm, EV_RXCHAR | EV_BREAK | EV_ERR)) {
+		MessageBox(NULL, "Error setting comm mask", "", MB_OK);
+		return false;
+	}
+
+	//bits on the wire per character, in tenths for 1.5 stop bits
+	DWORD tenthBits = 10 * (1 + dcb.ByteSize) + (dcb.Parity != NOPARITY ? 10 : 0);
+	tenthBits += (dcb.StopBits == ONESTOPBIT) ? 10 : (dcb.StopBits == ONE5STOPBITS) ? 15 : 20;
+
+	charTicks = frequency * tenthBits / (10 * (LONGLONG)dcb.BaudRate);
+	gapTicks = charTicks * 7 / 2;
+	if (dcb.BaudRate > MODBUS_FAST_BAUD) {
+		gapTicks = frequency * MODBUS_FAST_GAP_US / 1000000;
+	}
+
+	QueryPerformanceCounter(&counter);
+	sessionStart = counter.QuadPart;
+	lastArrival = 0;
+	frameLength = 0;
+	totalBytes = totalFrames = breakCount = errorCount = overrunCount = 0;
+	memset(gapHistogram, 0, sizeof(gapHistogram));
+
+	//keep other threads from delaying the timestamps
+	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+	return true;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: DrainInput
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static BOOL DrainInput(BYTE* readBuffer, OVERLAPPED* ov)
+--
+--	RETURNS:		BOOL - FALSE if reading from the port failed
+--
+--	NOTES:			Reads everything in the driver queue and stamps it, the last
+--					byte of each read with the time of the read and the ones before
+--					it a character time apart.
+-----------------------------------------------------------------------------------*/
+static BOOL DrainInput(BYTE* readBuffer, OVERLAPPED* ov) {
+	DWORD readBytes;
+	LARGE_INTEGER now;
+
+	do {
+		readBytes = 0;
+		if (!ReadFile(hComm, readBuffer, RX_BUFFER_SIZE, &readBytes, ov)) {
+			if (GetLastError() != ERROR_IO_PENDING
+				|| !GetOverlappedResult(hComm, ov, &readBytes, TRUE)) {
+				return false;
+			}
+		}
+		QueryPerformanceCounter(&now);
+
+		for (DWORD i = 0; i < readBytes; i++) {
+			LONGLONG arrival = now.QuadPart - (LONGLONG)(readBytes - 1 - i) * charTicks;
+			if (arrival < lastArrival + charTicks && lastArrival != 0) {
+				//the read was noticed late, the bytes cannot predate the last one
+				arrival = lastArrival + charTicks;
+			}
+			RecordByte(readBuffer[i], arrival);
+		}
+		CheckSteadyState(readBytes);
+	} while (readBytes == RX_BUFFER_SIZE);
+
+	return true;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: RecordLineEvent
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - queued for the window thread to print
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static void RecordLineEvent(DWORD mask)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Puts breaks and line errors on the timeline as they happen.
+-----------------------------------------------------------------------------------*/
+static void RecordLineEvent(DWORD mask) {
+	DWORD errors = 0;
+	COMSTAT stat;
+	LARGE_INTEGER now;
+	TIMELINEENTRY* entry;
+
+	QueryPerformanceCounter(&now);
+	ClearCommError(hComm, &errors, &stat);
+
+	if (mask & EV_BREAK) {
+		CloseFrame();
+		if ((entry = NextTimelineEntry(TIMELINE_BREAK, now.QuadPart)) != NULL) {
+			AddTimelineEntry();
+		}
+		breakCount++;
+	}
+	if (errors & (CE_FRAME | CE_RXPARITY | CE_OVERRUN | CE_RXOVER)) {
+		CloseFrame();
+		if ((entry = NextTimelineEntry(TIMELINE_ERROR, now.QuadPart)) != NULL) {
+			entry->errors = errors;
+			AddTimelineEntry();
+		}
+		errorCount++;
+		if (errors & (CE_OVERRUN | CE_RXOVER)) {
+			overrunCount++;
+		}
+	}
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: InitAnalyzer
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void InitAnalyzer()
+--
+--	RETURNS:		void
+--
+--	NOTES:			Reads the performance counter frequency, which is fixed at
+--					boot, for TicksToMicros, and carves the timeline ring out of
+--					the session arena.  Called once at startup, before any session
+--					or framing listing.
+-----------------------------------------------------------------------------------*/
+void InitAnalyzer() {
+	LARGE_INTEGER counter;
+
+	QueryPerformanceFrequency(&counter);
+	frequency = counter.QuadPart;
+
+	timeline = (TIMELINEENTRY*)ArenaAlloc(&sessionArena, TIMELINE_ENTRIES * sizeof(TIMELINEENTRY));
+	if (timeline == NULL) {
+		MessageBox(NULL, "Error allocating the analyzer timeline", "", MB_OK);
+		ExitProcess(1);
+	}
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: PrintTimeline
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - runs on the window thread, printing
+--									   whatever the read thread has queued
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void PrintTimeline()
+--
+--	RETURNS:		void
+--
+--	NOTES:			Handles WM_TIMELINE.  Formats every queued entry as a line of
+--					the timeline, stamped in milliseconds since the session was
+--					connected, and prints them together with PrintListing, since
+--					none of it was echoed by the device.  Entries dropped because
+--					the ring was full are counted on a line of their own.
+-----------------------------------------------------------------------------------*/
+void PrintTimeline() {
+	static char lines[TIMELINE_LISTING_SIZE];
+	int used = 0;
+
+	InterlockedExchange(&timelinePending, 0); // entries added from now on post again
+
+	LONG head = InterlockedCompareExchange(&timelineHead, 0, 0);
+	while (timelineTail != head) {
+		const TIMELINEENTRY* entry = &timeline[timelineTail & (TIMELINE_ENTRIES - 1)];
+		char* line = lines + used;
+		int size = sizeof(lines) - used;
+		LONGLONG us = TicksToMicros(entry->when);
+		int length = 0;
+
+		if (size < TIMELINE_LINE_MAX) {
+			PrintListing(lines, used); // full, print what there is so far
+			used = 0;
+			continue;
+		}
+
+		length += sprintf_s(line, size, "%9lld.%03lld ms  ", us / 1000, us % 1000);
+
+		switch (entry->kind) {
+		case TIMELINE_FRAME: {
+			LONGLONG gap = TicksToMicros(entry->gap);
+			LONGLONG maxGap = TicksToMicros(entry->maxGap);
+			length += sprintf_s(line + length, size - length, "gap %6lld.%03lld  len %5lu  max %lld.%03lld :",
+				gap / 1000, gap % 1000, entry->length, maxGap / 1000, maxGap % 1000);
+			for (DWORD i = 0; i < entry->length && i < ANALYZER_SHOWN_BYTES; i++) {
+				length += sprintf_s(line + length, size - length, " %02X", entry->bytes[i]);
+			}
+			if (entry->length > ANALYZER_SHOWN_BYTES) {
+				length += sprintf_s(line + length, size - length, " ...");
+			}
+			break;
+		}
+		case TIMELINE_BREAK:
+			length += sprintf_s(line + length, size - length, "BREAK");
+			break;
+		case TIMELINE_ERROR:
+			length += sprintf_s(line + length, size - length, "ERROR%s%s%s%s",
+				(entry->errors & CE_FRAME) ? " framing" : "",
+				(entry->errors & CE_RXPARITY) ? " parity" : "",
+				(entry->errors & CE_OVERRUN) ? " overrun" : "",
+				(entry->errors & CE_RXOVER) ? " queue-overflow" : "");
+			break;
+		}
+		length += sprintf_s(line + length, size - length, "\r\n");
+
+		used += length;
+		InterlockedIncrement(&timelineTail); // the read thread may reuse the entry now
+	}
+
+	LONG dropped = InterlockedExchange(&timelineDropped, 0);
+	if (dropped > 0) {
+		used += sprintf_s(lines + used, sizeof(lines) - used, "%ld timeline entries dropped\r\n", dropped);
+	}
+	if (used > 0) {
+		PrintListing(lines, used);
+	}
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: AnalyzeInput
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - waits for the pending comm event wait
+--									   to complete before returning
+--					October 19, 2026 - clears readThread only after the port
+--									   is closed
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		DWORD AnalyzeInput()
+--
+--	RETURNS:		DWORD
+--
+--	NOTES:			Read loop of the read thread in analyzer mode.  Waits for comm
+--					events a frame gap at a time, so the last frame is queued as
+--					soon as the line goes quiet, and closes the port when the
+--					session is disconnected.
+-----------------------------------------------------------------------------------*/
+DWORD AnalyzeInput() {
+	OVERLAPPED eventOv = { 0 };
+	OVERLAPPED readOv = { 0 };
+	DWORD mask = 0;
+	DWORD unused;
+	DWORD waitTime = READ_TIMEOUT;
+	BYTE* readBuffer = (BYTE*)PoolAlloc(&rxPool);
+	BOOL waitingOnEvent = FALSE;
+	LARGE_INTEGER now;
+
+	eventOv.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+	readOv.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+	if (eventOv.hEvent == NULL || readOv.hEvent == NULL || readBuffer == NULL || !StartAnalyzer()) {
+		OutputDebugString("Error starting analyzer");
+		connected = FALSE;
+	} else {
+		waitTime = (DWORD)(TicksToMicros(gapTicks) / 1000) + 1;
+	}
+
+	while (connected) {
+		if (!waitingOnEvent) {
+			mask = 0;
+			if (WaitCommEvent(hComm, &mask, &eventOv)) {
+				SetEvent(eventOv.hEvent);
+			} else if (GetLastError() != ERROR_IO_PENDING) {
+				MessageBox(NULL, "Error waiting on serial port", "", MB_OK);
+				break;
+			}
+			waitingOnEvent = TRUE;
+		}
+
+		switch (WaitForSingleObject(eventOv.hEvent, waitTime)) {
+		case WAIT_OBJECT_0:
+			waitingOnEvent = FALSE;
+			GetOverlappedResult(hComm, &eventOv, &unused, FALSE);
+			ResetEvent(eventOv.hEvent);
+			if (mask & (EV_BREAK | EV_ERR)) {
+				RecordLineEvent(mask);
+			}
+			if ((mask & EV_RXCHAR) && !DrainInput(readBuffer, &readOv)) {
+				MessageBox(NULL, "Error reading from serial port", "", MB_OK);
+				connected = FALSE;
+			}
+			break;
+		case WAIT_TIMEOUT:
+			//the line has gone quiet, finish the frame
+			QueryPerformanceCounter(&now);
+			if (frameLength > 0 && now.QuadPart - lastArrival >= gapTicks) {
+				CloseFrame();
+			}
+			break;
+		default:
+			connected = FALSE;
+			break;
+		}
+	}
+
+	CloseFrame();
+	if (waitingOnEvent) {
+		//the wait still points at eventOv and mask, let it finish first
+		SetCommMask(hComm, 0); // completes the pending WaitCommEvent
+		GetOverlappedResult(hComm, &eventOv, &unused, TRUE);
+	}
+	if (eventOv.hEvent != NULL) {
+		CloseHandle(eventOv.hEvent);
+	}
+	if (readOv.hEvent != NULL) {
+		CloseHandle(readOv.hEvent);
+	}
+	if (readBuffer != NULL) {
+		PoolFree(&rxPool, readBuffer);
+	}
+
+	StopWriter(&terminalWriter);
+	if (!CloseHandle(hComm)) {
+		OutputDebugString("Error closing handle");
+	} else {
+		OutputDebugString("thread closed");
+	}
+	readThread = 0; // only now can Connect start a new read thread
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: ShowGapHistogram
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void ShowGapHistogram()
+--
+--	RETURNS:		void
+--
+--	NOTES:			Shows the histogram of silences between bytes and the totals of
+--					the last analyzer session.
+-----------------------------------------------------------------------------------*/
+void ShowGapHistogram() {
+	char text[2048];
+	DWORD largest = 1;
+	int used;
+
+	for (int i = 0; i < GAP_BUCKETS; i++) {
+		largest = max(largest, gapHistogram[i]);
+	}
+
+	used = sprintf_s(text, sizeof(text), "%lu bytes, %lu frames, %lu breaks, %lu errors (%lu overruns)\n\n",
+		totalBytes, totalFrames, breakCount, errorCount, overrunCount);
+
+	for (int i = 0; i < GAP_BUCKETS; i++) {
+		char bar[33];
+		int length = (int)((ULONGLONG)gapHistogram[i] * 32 / largest);
+		memset(bar, '#', length);
+		bar[length] = '\0';
+
+		if (i == 0) {
+			used += sprintf_s(text + used, sizeof(text) - used, "          < 16 us\t%10lu  %s\n",
+				gapHistogram[i], bar);
+		} else if (i == GAP_BUCKETS - 1) {
+			used += sprintf_s(text + used, sizeof(text) - used, "    >= %8lu us\t%10lu  %s\n",
+				16UL << (i - 1), gapHistogram[i], bar);
+		} else {
+			used += sprintf_s(text + used, sizeof(text) - used, "%8lu - %8lu us\t%10lu  %s\n",
+				16UL << (i - 1), 16UL << i, gapHistogram[i], bar);
+		}
+	}
+
+	MessageBox(hwnd, text, "Gap Histogram", MB_OK);
+}
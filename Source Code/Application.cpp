@@ -10,13 +10,21 @@
 -- 						  LPSTR lspszCmdParam, int nCmdShow)
 --					LRESULT CALLBACK WndProc (HWND hwnd, UINT Message,
 --                        WPARAM wParam, LPARAM lParam)
---					void PrintToScreen(char readBuffer[])
+--					void PrintToScreen(char readBuffer[], DWORD length)
+--					void PrintListing(char text[], DWORD length)
 --					void SetConnectedUI()
 --					void SetDisconnectedUI()
 --
 --	DATE:			October 3, 2015
 --					
---	REVISIONS:		N/A
+--	REVISIONS:		October 19, 2026 - added predictive local echo
+--					October 19, 2026 - resizable window painted from the
+--									   scrollback in Screen.cpp
+--					October 19, 2026 - added the protocol analyzer menu
+--					October 19, 2026 - runs the bridge instead of the window
+--									   when started with /bridge
+--					October 19, 2026 - Port menu filled by port discovery
+--					October 19, 2026 - added the COBS and SLIP framing menu
 --
 --	DESIGNER:		Alvin Man
 --
@@ -39,6 +47,8 @@
 #include <windows.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <dbt.h>
 #include "header.h"
 
 #pragma warning (disable: 4096)
@@ -51,21 +61,31 @@ static TCHAR Name[] = TEXT("DumbTerminal");
 static TCHAR HelpMessage[] = TEXT("This program allows you to make a connection ")
 TEXT("between serial ports to transmit characters.\nUse the Communication ")
 TEXT("Parameters to set the correct COM settings.\nUse the Port Menu ")
-TEXT("to choose a COM Port.\nUse the File menu to Connect and Disconnect ")
-TEXT("from the COM ports.");
+TEXT("to choose a COM Port; ports are found when the program starts and ")
+TEXT("when adapters are plugged in.\nUse the File menu to Connect and Disconnect ")
+TEXT("from the COM ports.\nUse the Options menu to draw typed characters ")
+TEXT("before the device echoes them back, or to timestamp received bytes ")
+TEXT("with the protocol analyzer, or to list COBS or SLIP packets. In ")
+TEXT("framing mode, typed text is sent as one packet when Enter is pressed.");
 HWND hwnd;     
 WNDCLASSEX Wcl;			
 COLORREF backgroundColor = RGB(51, 51, 51);
 COLORREF textColor = RGB(179, 255, 0);
 HMENU programMenu;
-int X = 0, Y = 0; //initial starting coordinates for character printing
+CRITICAL_SECTION screenLock;
+static LONG scrollBarPending = 0; // WM_SCREEN_CHANGED posted and not handled yet
 
 /*-----------------------------------------------------------------------------------
 --	FUNCTION: WinMain
 --
 --	DATE:			October 3, 2015
 --					
---	REVISIONS:		N/A
+--	REVISIONS:		October 19, 2026 - resizable window, session memory set
+--									   up before it is created
+--					October 19, 2026 - runs the bridge when started with
+--									   /bridge
+--					October 19, 2026 - starts port discovery
+--					October 19, 2026 - sets up framing
 --
 --	DESIGNER:		Alvin Man
 --
@@ -79,12 +99,31 @@ int X = 0, Y = 0; //initial starting coordinates for character printing
 --	NOTES:			This is the initial entry point for the program.  It is
 --					responsible for the message retrieval and dispatch loop that
 --					that provides top-level control for the remainder of execution.
+--
+--					Started as "DumbTerminal /bridge ...", no window is created and
+--					the program runs the serial to TCP bridge instead.
 -----------------------------------------------------------------------------------*/
 int WINAPI WinMain (HINSTANCE hInst, HINSTANCE hprevInstance,
  						  LPSTR lspszCmdParam, int nCmdShow)
 {
 	MSG Msg;
 
+	InitializeCriticalSection(&screenLock);
+	InitWriteQueue(&terminalWriter, &writePool);
+	InitMemory();
+
+	// Run headless, bridging ports to TCP, when started with /bridge
+	size_t switchLength = strlen(BRIDGE_SWITCH);
+	if (_strnicmp(lspszCmdParam, BRIDGE_SWITCH, switchLength) == 0
+		&& (lspszCmdParam[switchLength] == '\0' || lspszCmdParam[switchLength] == ' '
+			|| lspszCmdParam[switchLength] == '\t')) {
+		return RunBridge(lspszCmdParam + switchLength);
+	}
+
+	InitScreen();
+	InitAnalyzer();
+	InitFraming();
+
 	// Define a Window class
 	Wcl.cbSize = sizeof (WNDCLASSEX);
 	Wcl.style = 0; // default style
@@ -109,7 +148,7 @@ int WINAPI WinMain (HINSTANCE hInst, HINSTANCE hprevInstance,
 	hwnd = CreateWindow (
 		"Firstclass", // name of window class
 		Name, // title 
-		WS_OVERLAPPED | WS_CAPTION | WS_SYSMENU | WS_MINIMIZEBOX | WS_MAXIMIZEBOX, // window style - non-resizable
+		WS_OVERLAPPEDWINDOW | WS_VSCROLL, // window style - resizable, with scrollback
 		CW_USEDEFAULT,	// X coord
 		CW_USEDEFAULT, // Y coord
    		600, // width
@@ -124,6 +163,9 @@ int WINAPI WinMain (HINSTANCE hInst, HINSTANCE hprevInstance,
 	ShowWindow (hwnd, nCmdShow);
 	UpdateWindow (hwnd);
 
+	// Fill the Port menu in the background
+	DiscoverPorts(TRUE);
+
 	// Create the message loop
 	while (GetMessage (&Msg, NULL, 0, 0))
 	{
@@ -139,7 +181,14 @@ int WINAPI WinMain (HINSTANCE hInst, HINSTANCE hprevInstance,
 --
 --	DATE:			October 3, 2015
 --
---	REVISIONS:		N/A
+--	REVISIONS:		October 19, 2026 - added predictive echo, scrolling,
+--									   resizing and analyzer messages
+--					October 19, 2026 - handles discovered ports and device
+--									   changes
+--					October 19, 2026 - typed characters build a payload in
+--									   framing mode
+--					October 19, 2026 - scroll bar drags use the 32 bit track
+--									   position
 --
 --	DESIGNER:		Alvin Man
 --
@@ -156,6 +205,8 @@ LRESULT CALLBACK WndProc (HWND hwnd, UINT Message,
                           WPARAM wParam, LPARAM lParam)
 {
 	PAINTSTRUCT paintstruct;
+	SCROLLINFO scrollInfo;
+	FRAMING chosen;
 
 	switch (Message)
 	{
@@ -171,25 +222,47 @@ LRESULT CALLBACK WndProc (HWND hwnd, UINT Message,
 				case IDM_ConnParams:
 					GetCommParameters();
 					break;
-				case IDM_COM1:
-					lpszCommName = "COM1";
-					MessageBox(hwnd, "Port set to COM1", "", MB_OK);
+				case IDM_RefreshPorts:
+					DiscoverPorts(TRUE);
+					break;
+				case IDM_Predict:
+					SetPrediction(!predictEnabled);
+					CheckMenuItem(GetMenu(hwnd), IDM_Predict, predictEnabled ? MF_CHECKED : MF_UNCHECKED);
+					if (predictEnabled) {
+						SetTimer(hwnd, IDT_PREDICT, PREDICT_INTERVAL, NULL);
+					} else {
+						KillTimer(hwnd, IDT_PREDICT);
+					}
 					break;
-				case IDM_COM2:
-					lpszCommName = "COM2";
-					MessageBox(hwnd, "Port set to COM2", "", MB_OK);
+				case IDM_Analyzer:
+					analyzerEnabled = !analyzerEnabled;
+					if (analyzerEnabled) {
+						SetFraming(FRAMING_OFF); // both take over the read thread
+					}
+					CheckMenuItem(GetMenu(hwnd), IDM_Analyzer, analyzerEnabled ? MF_CHECKED : MF_UNCHECKED);
+					CheckMenuItem(GetMenu(hwnd), IDM_FrameCOBS, (framingMode == FRAMING_COBS) ? MF_CHECKED : MF_UNCHECKED);
+					CheckMenuItem(GetMenu(hwnd), IDM_FrameSLIP, (framingMode == FRAMING_SLIP) ? MF_CHECKED : MF_UNCHECKED);
 					break;
-				case IDM_COM3:
-					lpszCommName = "COM3";
-					MessageBox(hwnd, "Port set to COM3", "", MB_OK);
+				case IDM_Histogram:
+					ShowGapHistogram();
 					break;
-				case IDM_COM4:
-					lpszCommName = "COM4";
-					MessageBox(hwnd, "Port set to COM4", "", MB_OK);
+				case IDM_FrameCOBS:
+				case IDM_FrameSLIP:
+					chosen = (LOWORD(wParam) == IDM_FrameCOBS) ? FRAMING_COBS : FRAMING_SLIP;
+					SetFraming((framingMode == chosen) ? FRAMING_OFF : chosen); // chosen again turns it off
+					if (framingMode != FRAMING_OFF) {
+						analyzerEnabled = FALSE;
+					}
+					CheckMenuItem(GetMenu(hwnd), IDM_Analyzer, analyzerEnabled ? MF_CHECKED : MF_UNCHECKED);
+					CheckMenuItem(GetMenu(hwnd), IDM_FrameCOBS, (framingMode == FRAMING_COBS) ? MF_CHECKED : MF_UNCHECKED);
+					CheckMenuItem(GetMenu(hwnd), IDM_FrameSLIP, (framingMode == FRAMING_SLIP) ? MF_CHECKED : MF_UNCHECKED);
 					break;
-				case IDM_COM5:
-					lpszCommName = "COM5";
-					MessageBox(hwnd, "Port set to COM5", "", MB_OK);
+				case IDM_AutoBaud:
+					autoBaudEnabled = !autoBaudEnabled;
+					CheckMenuItem(GetMenu(hwnd), IDM_AutoBaud, autoBaudEnabled ? MF_CHECKED : MF_UNCHECKED);
+					if (autoBaudEnabled) {
+						DiscoverPorts(TRUE);
+					}
 					break;
 				case IDM_HELP:
 					MessageBox(hwnd, HelpMessage, "Help", MB_OK);
@@ -197,11 +270,22 @@ LRESULT CALLBACK WndProc (HWND hwnd, UINT Message,
 				case IDM_Exit:
 					PostQuitMessage(0);
 					break;
+				default:
+					if (LOWORD(wParam) >= IDM_PORT_BASE && LOWORD(wParam) < IDM_PORT_BASE + MAX_PORTS) {
+						SelectPort(LOWORD(wParam) - IDM_PORT_BASE);
+					}
+					break;
 				}
 			break;
 		case WM_KEYDOWN:
 			switch (wParam)
 			{
+			case VK_PRIOR:
+				ScrollScreen(-SCROLL_PAGE);
+				break;
+			case VK_NEXT:
+				ScrollScreen(SCROLL_PAGE);
+				break;
 			case VK_ESCAPE:
 				if (connected != FALSE) {
 					connected = FALSE;
@@ -211,10 +295,82 @@ LRESULT CALLBACK WndProc (HWND hwnd, UINT Message,
 			}
 			break;
 		case WM_CHAR:	// Process keystroke
+			if (framingMode != FRAMING_OFF) {
+				FrameKeystroke((char)wParam); // sent as a packet on Enter
+				break;
+			}
+			if (!analyzerEnabled) { // the analyzer never shows an echo to confirm
+				PredictKeystroke((char)wParam);
+				UpdateWindow(hwnd); // draw it before the echo arrives
+			}
 			WriteToSerial(wParam);
 			break;
+		case WM_SIZE:
+			ResizeScreen(LOWORD(lParam), HIWORD(lParam));
+			break;
+		case WM_VSCROLL:
+			switch (LOWORD(wParam))
+			{
+			case SB_LINEUP:
+				ScrollScreen(-1);
+				break;
+			case SB_LINEDOWN:
+				ScrollScreen(1);
+				break;
+			case SB_PAGEUP:
+				ScrollScreen(-SCROLL_PAGE);
+				break;
+			case SB_PAGEDOWN:
+				ScrollScreen(SCROLL_PAGE);
+				break;
+			case SB_THUMBTRACK:
+			case SB_THUMBPOSITION:
+				// HIWORD(wParam) only holds 16 bits of the position
+				scrollInfo.cbSize = sizeof(SCROLLINFO);
+				scrollInfo.fMask = SIF_TRACKPOS;
+				if (GetScrollInfo(hwnd, SB_VERT, &scrollInfo)) {
+					ScrollScreenTo(scrollInfo.nTrackPos);
+				}
+				break;
+			}
+			break;
+		case WM_MOUSEWHEEL:
+			ScrollScreen(-GET_WHEEL_DELTA_WPARAM(wParam) / WHEEL_DELTA * SCROLL_WHEEL);
+			break;
+		case WM_ERASEBKGND:	// PaintScreen covers the whole client area
+			return 1;
+		case WM_TIMER:
+			if (wParam == IDT_PREDICT) {
+				ExpirePredictions();
+			} else if (wParam == IDT_DISCOVERY) {
+				ProbesTimedOut();
+			} else if (wParam == IDT_REFRESH) {
+				KillTimer(hwnd, IDT_REFRESH);
+				DiscoverPorts(FALSE);
+			}
+			break;
+		case WM_SCREEN_CHANGED:	// received text moved the end of the scrollback
+			InterlockedExchange(&scrollBarPending, 0);
+			UpdateScrollBar();
+			break;
+		case WM_TIMELINE:	// the analyzer has frames to list
+			PrintTimeline();
+			break;
+		case WM_PORT_PROBED:
+			PortProbed(lParam);
+			break;
+		case WM_DEVICECHANGE:	// adapters plugged in or out, refresh once they settle
+			if (wParam == DBT_DEVICEARRIVAL || wParam == DBT_DEVICEREMOVECOMPLETE || wParam == DBT_DEVNODES_CHANGED) {
+				SetTimer(hwnd, IDT_REFRESH, REFRESH_DELAY, NULL);
+			}
+			return TRUE;
+		case WM_PREDICT_OFF:	// too many mispredictions
+			KillTimer(hwnd, IDT_PREDICT);
+			CheckMenuItem(GetMenu(hwnd), IDM_Predict, MF_UNCHECKED);
+			break;
 		case WM_PAINT:		// Process a repaint message
 			hdc = BeginPaint(hwnd, &paintstruct); // Acquire DC
+			PaintScreen(hdc);
 			EndPaint(hwnd, &paintstruct); // Release DC
 			break;
 		case WM_DESTROY:		// message to terminate the program
@@ -231,47 +387,72 @@ LRESULT CALLBACK WndProc (HWND hwnd, UINT Message,
 --
 --	DATE:			October 3, 2015
 --
---	REVISIONS:		N/A
+--	REVISIONS:		October 19, 2026 - prints exactly the bytes read, one at a
+--									   time, so each can confirm a prediction
+--					October 19, 2026 - writes into the scrollback, the window
+--									   thread paints it
+--					October 19, 2026 - asks the window thread to update the
+--									   scroll bar
 --
 --	DESIGNER:		Alvin Man
 --
 --	PROGRAMMER:		Alvin Man
 --
---	INTERFACE:		void PrintToScreen(char readBuffer[])
+--	INTERFACE:		void PrintToScreen(char readBuffer[], DWORD length)
 --
 --	RETURNS:		void
 --
 --	NOTES:			Handles the printing of characters received via the serial port
---					to the screen.  
+--					to the screen.
 -----------------------------------------------------------------------------------*/
-void PrintToScreen(char readBuffer[]) {
+void PrintToScreen(char readBuffer[], DWORD length) {
 
-	SIZE lastCharWidth;
-	hdc = GetDC(hwnd);
-	RECT windowDimension;
-
-	//determine width of the window
-	GetWindowRect(hwnd, &windowDimension);
-	int windowWidth = windowDimension.right - windowDimension.left;
-
-	//get the width of the last character read
-	GetTextExtentPoint32(hdc, readBuffer, 1, &lastCharWidth);
+	EnterCriticalSection(&screenLock);
+	for (DWORD i = 0; i < length; i++) {
+		ConfirmPrediction(readBuffer[i]);
+		ScreenPutChar(readBuffer[i]);
+		RevealPredictions();
+	}
+	LeaveCriticalSection(&screenLock);
 
-	//print the characters
-	SetBkMode(hdc, TRANSPARENT);
-	SetTextColor(hdc, textColor);
-	TextOut(hdc, X, Y, readBuffer, 10);
+	InvalidateRect(hwnd, NULL, FALSE); // repainted by the window thread
+	if (InterlockedExchange(&scrollBarPending, 1) == 0) {
+		PostMessage(hwnd, WM_SCREEN_CHANGED, 0, 0); // at most one waiting at a time
+	}
+}
 
-	//increment the screen paint coordinates by the amount of the last char width
-	X += lastCharWidth.cx; 
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: PrintListing
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void PrintListing(char text[], DWORD length)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Prints text the program generated itself, such as the analyzer
+--					timeline.  Unlike PrintToScreen it leaves predictions alone:
+--					the text was not echoed by the device, so it must neither
+--					confirm nor roll back what was typed.
+-----------------------------------------------------------------------------------*/
+void PrintListing(char text[], DWORD length) {
 
-	//if the printed characters exceed window width, jump to the next line
-	if (X > windowWidth - 20) {
-		X = 0;
-		Y += 15;
+	EnterCriticalSection(&screenLock);
+	for (DWORD i = 0; i < length; i++) {
+		ScreenPutChar(text[i]);
 	}
+	LeaveCriticalSection(&screenLock);
 
-	ReleaseDC((HWND)hwnd, hdc); // Release device context
+	InvalidateRect(hwnd, NULL, FALSE); // repainted by the window thread
+	if (InterlockedExchange(&scrollBarPending, 1) == 0) {
+		PostMessage(hwnd, WM_SCREEN_CHANGED, 0, 0); // at most one waiting at a time
+	}
 }
 
 /*-----------------------------------------------------------------------------------
@@ -279,7 +460,8 @@ void PrintToScreen(char readBuffer[]) {
 --
 --	DATE:			October 3, 2015
 --
---	REVISIONS:		N/A
+--	REVISIONS:		October 19, 2026 - rebuilds the Port menu, whose ports are
+--									   grayed while connected
 --
 --	DESIGNER:		Alvin Man
 --
@@ -295,11 +477,10 @@ void PrintToScreen(char readBuffer[]) {
 -----------------------------------------------------------------------------------*/
 void SetConnectedUI() {
 	programMenu = GetMenu(hwnd);
-	EnableMenuItem(programMenu, IDM_COM1, MF_GRAYED);
-	EnableMenuItem(programMenu, IDM_COM2, MF_GRAYED);
-	EnableMenuItem(programMenu, IDM_COM3, MF_GRAYED);
-	EnableMenuItem(programMenu, IDM_COM4, MF_GRAYED);
-	EnableMenuItem(programMenu, IDM_COM5, MF_GRAYED);
+	BuildPortMenu(); // grays the ports, leaving Refresh
+	EnableMenuItem(programMenu, IDM_Analyzer, MF_GRAYED);
+	EnableMenuItem(programMenu, IDM_FrameCOBS, MF_GRAYED);
+	EnableMenuItem(programMenu, IDM_FrameSLIP, MF_GRAYED);
 	EnableMenuItem(programMenu, IDM_Connect, MF_GRAYED);
 	EnableMenuItem(programMenu, IDM_Disconnect, MF_ENABLED);
 	DrawMenuBar(hwnd);
@@ -310,7 +491,8 @@ void SetConnectedUI() {
 --
 --	DATE:			October 3, 2015
 --
---	REVISIONS:		N/A
+--	REVISIONS:		October 19, 2026 - rebuilds the Port menu, whose ports are
+--									   grayed while connected
 --
 --	DESIGNER:		Alvin Man
 --
@@ -326,11 +508,10 @@ void SetConnectedUI() {
 -----------------------------------------------------------------------------------*/
 void SetDisconnectedUI() {
 	programMenu = GetMenu(hwnd);
-	EnableMenuItem(programMenu, IDM_COM1, MF_ENABLED);
-	EnableMenuItem(programMenu, IDM_COM2, MF_ENABLED);
-	EnableMenuItem(programMenu, IDM_COM3, MF_ENABLED);
-	EnableMenuItem(programMenu, IDM_COM4, MF_ENABLED);
-	EnableMenuItem(programMenu, IDM_COM5, MF_ENABLED);
+	BuildPortMenu();
+	EnableMenuItem(programMenu, IDM_Analyzer, MF_ENABLED);
+	EnableMenuItem(programMenu, IDM_FrameCOBS, MF_ENABLED);
+	EnableMenuItem(programMenu, IDM_FrameSLIP, MF_ENABLED);
 	EnableMenuItem(programMenu, IDM_Connect, MF_ENABLED);
 	EnableMenuItem(programMenu, IDM_Disconnect, MF_GRAYED);
 	DrawMenuBar(hwnd);
@@ -0,0 +1,882 @@
+/*-----------------------------------------------------------------------------------
+--	SOURCE FILE:	Bridge.cpp - Headless serial to TCP bridge, exposing each serial
+--								 port as a TCP listener that any number of
+--								 clients can attach to.
+--
+--	PROGRAM:        Terminal Emulator
+--
+--	FUNCTIONS:
+--					int RunBridge(LPSTR args)
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - each port has its own buffer pool, and
+--									   clients whose sends stall are dropped
+--					October 19, 2026 - client writes wait for the port's write
+--									   queue instead of being dropped
+--					October 19, 2026 - diagnostics reach the operator's console
+--					October 19, 2026 - a port that stops reading ends the bridge
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	NOTES:			Bridge.cpp is part of a minimal Windows terminal emulator,
+--					that transmits characters typed on the keyboard to the serial
+--					port and displays all characters received via the serial port.
+--
+--					Started as
+--
+--						DumbTerminal /bridge COM3=4001 COM4=4002:115200
+--							[/policy drop|disconnect] [/queue buffers]
+--
+--					no window is created.  Each port is opened with OpenCommPort,
+--					at its current settings or the given baud rate, and gets a
+--					reader thread, a writer queue and a TCP listener.
+--
+--					The reader reads into a reference counted buffer from the
+--					port's own pool and hands the same buffer to every attached
+--					client, so fanning out to N clients copies nothing.  The last
+--					client to send it returns it to the pool.  Each client may fall
+--					behind by at most /queue buffers; beyond that its new data is
+--					dropped or it is disconnected, depending on /policy, so a slow
+--					client can never hold up the reader.  A port's pool holds
+--					enough buffers for every client's queue to be full at once, so
+--					stalled clients cannot starve the other clients of their port
+--					or any other port.  A client whose socket accepts nothing for
+--					BRIDGE_SEND_TIMEOUT is disconnected, which releases its buffers.
+--					Data received from any client is written to the port through
+--					the port's write queue, whose nodes come from a pool of its own.
+--					While that queue is full the client is not read from, so TCP
+--					flow control slows it to the speed of the serial line and one
+--					busy port cannot use up the nodes of another.
+--
+--					If a port cannot be read any more, say because its USB adapter
+--					was unplugged, its listener is closed, its clients are
+--					disconnected and the bridge exits with a non-zero code, so a
+--					supervisor can restart it once the port is back, rather than
+--					leaving the port silently dead.
+--
+--					The pools are carved out of a bridge arena sized for the ports
+--					and /queue given, allocated once at startup.
+--
+--					Diagnostics go to OutputDebugString and to stderr, or to the
+--					console of the command prompt the bridge was started from.
+-----------------------------------------------------------------------------------*/
+
+#define STRICT
+
+#include <winsock2.h>
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "header.h"
+
+#pragma comment(lib, "ws2_32.lib")
+
+#define BRIDGE_MAX_PORTS      MAXIMUM_WAIT_OBJECTS
+#define BRIDGE_MAX_CLIENTS    16      // clients attached to one port
+#define BRIDGE_CLIENTS        256     // clients attached to all ports
+#define BRIDGE_READ_SIZE      1024    // bytes in a shared receive buffer
+#define BRIDGE_QUEUE_MAX      256     // most buffers a client may fall behind by
+#define BRIDGE_QUEUE_DEFAULT  64
+#define BRIDGE_RECEIVE_SIZE   1024    // bytes read from a client at a time
+#define BRIDGE_WRITE_NODES    64      // write nodes of one port
+#define BRIDGE_DRAIN_WAIT     100     // ms between retries of a full write queue
+#define BRIDGE_SEND_TIMEOUT   5000    // milliseconds a send may block before the client is dropped
+
+// Buffers one port needs: a full queue and one being sent per client, plus the reader's
+#define BRIDGE_PORT_BUFFERS(queue)  (BRIDGE_MAX_CLIENTS * ((queue) + 1) + 1)
+
+// What happens to a client whose queue is full
+typedef enum {
+	POLICY_DROP,          // its new data is dropped
+	POLICY_DISCONNECT     // it is disconnected
+} SLOWPOLICY;
+
+// Data read from a port, shared by every client it is sent to
+typedef struct {
+	LONG refs;
+	DWORD length;
+	char data[BRIDGE_READ_SIZE];
+} SHAREDBUF;
+
+struct BRIDGEPORT;
+
+// A TCP client attached to a port
+typedef struct {
+	SOCKET sock;
+	struct BRIDGEPORT* port;
+	CRITICAL_SECTION lock;                // guards the queue and closing
+	SHAREDBUF* queue[BRIDGE_QUEUE_MAX];   // ring of buffers still to send
+	int head;
+	int count;
+	BOOL closing;
+	HANDLE ready;                         // signalled when data is queued or closing
+	DWORD dropped;                        // bytes dropped under POLICY_DROP
+} BRIDGECLIENT;
+
+// A serial port and its TCP listener
+typedef struct BRIDGEPORT {
+	char name[16];
+	USHORT tcpPort;
+	DWORD baudRate;                       // 0 keeps the port's settings
+	HANDLE comm;
+	SOCKET listener;
+	WRITEQUEUE writer;
+	CRITICAL_SECTION clientLock;          // guards clients
+	BRIDGECLIENT* clients[BRIDGE_MAX_CLIENTS];
+	POOL buffers;                         // SHAREDBUF blocks of this port
+	POOL writeNodes;                      // WRITENODE blocks of this port's writer
+	HANDLE reader;
+	DWORD dropped;                        // bytes read while the pool was empty
+} BRIDGEPORT;
+
+// declared variables
+static BRIDGEPORT bridgePorts[BRIDGE_MAX_PORTS];
+static int bridgePortCount = 0;
+static ARENA bridgeArena;                 // per-port pools
+static POOL clientPool;                   // BRIDGECLIENT blocks
+static SLOWPOLICY slowPolicy = POLICY_DROP;
+static int queueLimit = BRIDGE_QUEUE_DEFAULT;
+static HANDLE logOutput = INVALID_HANDLE_VALUE; // stderr or the parent's console
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: BridgeLog
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - also written to the operator's console
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static void BridgeLog(const char* format, ...)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Formats a diagnostic line for the debugger, and writes it to
+--					the log output opened by OpenBridgeLog, if any, as one write
+--					so lines from different threads do not interleave.
+-----------------------------------------------------------------------------------*/
+static void BridgeLog(const char* format, ...) {
+	char message[256];
+	DWORD written;
+	va_list args;
+
+	va_start(args, format);
+	_vsnprintf_s(message, sizeof(message) - 2, _TRUNCATE, format, args);
+	va_end(args);
+	OutputDebugString(message);
+
+	if (logOutput != INVALID_HANDLE_VALUE) {
+		strcat_s(message, sizeof(message), "\r\n");
+		WriteFile(logOutput, message, (DWORD)strlen(message), &written, NULL);
+	}
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: OpenBridgeLog
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static void OpenBridgeLog()
+--
+--	RETURNS:		void
+--
+--	NOTES:			Finds somewhere an operator can read the bridge's diagnostics.
+--					A GUI program has no console of its own, so this is stderr
+--					when it was redirected, otherwise the console of the command
+--					prompt the bridge was started from.  Started with neither,
+--					diagnostics only go to the debugger.
+-----------------------------------------------------------------------------------*/
+static void OpenBridgeLog() {
+	HANDLE output = GetStdHandle(STD_ERROR_HANDLE);
+
+	if (output != NULL && output != INVALID_HANDLE_VALUE) {
+		logOutput = output;
+	} else if (AttachConsole(ATTACH_PARENT_PROCESS)) {
+		logOutput = CreateFile("CONOUT$", GENERIC_WRITE, FILE_SHARE_WRITE, NULL, OPEN_EXISTING, 0, NULL);
+	}
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: ReleaseBuffer
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static void ReleaseBuffer(BRIDGEPORT* port, SHAREDBUF* buffer)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Drops a reference, returning the buffer to the port's pool with
+--					the last one.
+-----------------------------------------------------------------------------------*/
+static void ReleaseBuffer(BRIDGEPORT* port, SHAREDBUF* buffer) {
+	if (InterlockedDecrement(&buffer->refs) == 0) {
+		PoolFree(&port->buffers, buffer);
+	}
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: CloseClient
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static void CloseClient(BRIDGECLIENT* client)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Marks a client as closing and shuts its socket down, which ends
+--					its threads.  Caller holds the client's lock.
+-----------------------------------------------------------------------------------*/
+static void CloseClient(BRIDGECLIENT* client) {
+	if (!client->closing) {
+		client->closing = TRUE;
+		shutdown(client->sock, SD_BOTH);
+		SetEvent(client->ready);
+	}
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: EnqueueBuffer
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static void EnqueueBuffer(BRIDGECLIENT* client, SHAREDBUF* buffer)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Queues a reference to the buffer for the client to send, or
+--					applies the slow client policy if its queue is full.  Never
+--					blocks on the client.
+-----------------------------------------------------------------------------------*/
+static void EnqueueBuffer(BRIDGECLIENT* client, SHAREDBUF* buffer) {
+	EnterCriticalSection(&client->lock);
+	if (client->closing) {
+		//nothing more is sent to it
+	} else if (client->count < queueLimit) {
+		InterlockedIncrement(&buffer->refs);
+		client->queue[(client->head + client->count) % BRIDGE_QUEUE_MAX] = buffer;
+		client->count++;
+		SetEvent(client->ready);
+	} else if (slowPolicy == POLICY_DROP) {
+		client->dropped += buffer->length;
+	} else {
+		BridgeLog("%s: disconnecting slow client", client->port->name);
+		CloseClient(client);
+	}
+	LeaveCriticalSection(&client->lock);
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: SenderThread
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static DWORD WINAPI SenderThread(LPVOID param)
+--
+--	RETURNS:		DWORD
+--
+--	NOTES:			Sends a client's queued buffers, releasing each once sent.
+--					Exits when the client is closing.
+-----------------------------------------------------------------------------------*/
+static DWORD WINAPI SenderThread(LPVOID param) {
+	BRIDGECLIENT* client = (BRIDGECLIENT*)param;
+
+	while (1) {
+		WaitForSingleObject(client->ready, INFINITE);
+
+		while (1) {
+			EnterCriticalSection(&client->lock);
+			if (client->closing) {
+				LeaveCriticalSection(&client->lock);
+				return 0;
+			}
+			if (client->count == 0) {
+				LeaveCriticalSection(&client->lock);
+				break;
+			}
+			SHAREDBUF* buffer = client->queue[client->head];
+			client->head = (client->head + 1) % BRIDGE_QUEUE_MAX;
+			client->count--;
+			LeaveCriticalSection(&client->lock);
+
+			DWORD length = buffer->length;
+			DWORD sent = 0;
+			while (sent < length) {
+				int result = send(client->sock, buffer->data + sent, length - sent, 0);
+				if (result == SOCKET_ERROR) {
+					break;
+				}
+				sent += result;
+			}
+			ReleaseBuffer(client->port, buffer);
+
+			//an error, or a send blocked for BRIDGE_SEND_TIMEOUT
+			if (sent < length) {
+				EnterCriticalSection(&client->lock);
+				CloseClient(client);
+				LeaveCriticalSection(&client->lock);
+			}
+		}
+	}
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: ClientThread
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - waits for the write queue instead of
+--									   dropping client data
+--					October 19, 2026 - keeps its slot until its buffers are
+--									   released
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static DWORD WINAPI ClientThread(LPVOID param)
+--
+--	RETURNS:		DWORD
+--
+--	NOTES:			Writes whatever a client sends to the port until its socket is
+--					closed, then detaches the client from the port and frees it.
+--					Runs the client's sender thread alongside.  The client keeps
+--					its slot until its sender has exited and its queue is released,
+--					so the clients of a port never hold more buffers than the
+--					port's pool was sized for.  While the port's
+--					write queue is full nothing more is received, so TCP flow
+--					control holds the client back rather than its data being
+--					dropped.
+-----------------------------------------------------------------------------------*/
+static DWORD WINAPI ClientThread(LPVOID param) {
+	BRIDGECLIENT* client = (BRIDGECLIENT*)param;
+	BRIDGEPORT* port = client->port;
+	char data[BRIDGE_RECEIVE_SIZE];
+	int received;
+
+	HANDLE sender = CreateThread(NULL, 0, SenderThread, client, 0, NULL);
+	if (sender == NULL) {
+		EnterCriticalSection(&client->lock);
+		CloseClient(client);
+		LeaveCriticalSection(&client->lock);
+	} else {
+		//not receiving while the port's queue is full pushes back on the client
+		while ((received = recv(client->sock, data, sizeof(data), 0)) > 0) {
+			while (!QueueWrite(&port->writer, data, received) && !client->closing) {
+				WaitForSingleObject(port->writer.drained, BRIDGE_DRAIN_WAIT);
+			}
+			if (client->closing) {
+				break;
+			}
+		}
+	}
+
+	//once closing, the reader queues nothing more for this client
+	EnterCriticalSection(&client->lock);
+	CloseClient(client);
+	LeaveCriticalSection(&client->lock);
+	if (sender != NULL) {
+		WaitForSingleObject(sender, INFINITE);
+		CloseHandle(sender);
+	}
+
+	while (client->count > 0) {
+		ReleaseBuffer(port, client->queue[client->head]);
+		client->head = (client->head + 1) % BRIDGE_QUEUE_MAX;
+		client->count--;
+	}
+	if (client->dropped > 0) {
+		BridgeLog("%s: client left, %lu bytes dropped", port->name, client->dropped);
+	}
+
+	//only now that it holds no buffers can its slot go to a new client
+	EnterCriticalSection(&port->clientLock);
+	for (int i = 0; i < BRIDGE_MAX_CLIENTS; i++) {
+		if (port->clients[i] == client) {
+			port->clients[i] = NULL;
+		}
+	}
+	LeaveCriticalSection(&port->clientLock);
+
+	closesocket(client->sock);
+	CloseHandle(client->ready);
+	DeleteCriticalSection(&client->lock);
+	PoolFree(&clientPool, client);
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: AttachClient
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static void AttachClient(BRIDGEPORT* port, SOCKET sock)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Takes a client from the pool, puts it on the port's list and
+--					starts its thread.  The socket is closed if the port is full.
+-----------------------------------------------------------------------------------*/
+static void AttachClient(BRIDGEPORT* port, SOCKET sock) {
+	BRIDGECLIENT* client = (BRIDGECLIENT*)PoolAlloc(&clientPool);
+	int slot = -1;
+	BOOL noDelay = TRUE;
+	DWORD sendTimeout = BRIDGE_SEND_TIMEOUT;
+
+	if (client == NULL) {
+		BridgeLog("%s: too many clients, connection refused", port->name);
+		closesocket(sock);
+		return;
+	}
+
+	//keystrokes from interactive clients should not wait for a full segment
+	setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+	//a client that stops reading fails its send instead of holding its buffers forever
+	setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, (const char*)&sendTimeout, sizeof(sendTimeout));
+
+	client->sock = sock;
+	client->port = port;
+	client->head = 0;
+	client->count = 0;
+	client->closing = FALSE;
+	client->dropped = 0;
+	client->ready = CreateEvent(NULL, FALSE, FALSE, NULL);
+	InitializeCriticalSection(&client->lock);
+
+	EnterCriticalSection(&port->clientLock);
+	for (int i = 0; i < BRIDGE_MAX_CLIENTS && slot < 0; i++) {
+		if (port->clients[i] == NULL) {
+			slot = i;
+		}
+	}
+	if (slot >= 0 && client->ready != NULL) {
+		port->clients[slot] = client;
+	}
+	LeaveCriticalSection(&port->clientLock);
+
+	if (slot >= 0 && client->ready != NULL) {
+		HANDLE thread = CreateThread(NULL, 0, ClientThread, client, 0, NULL);
+		if (thread != NULL) {
+			CloseHandle(thread);
+			return;
+		}
+		EnterCriticalSection(&port->clientLock);
+		port->clients[slot] = NULL;
+		LeaveCriticalSection(&port->clientLock);
+	}
+
+	BridgeLog("%s: could not attach client", port->name);
+	if (client->ready != NULL) {
+		CloseHandle(client->ready);
+	}
+	DeleteCriticalSection(&client->lock);
+	PoolFree(&clientPool, client);
+	closesocket(sock);
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: ListenerThread
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static DWORD WINAPI ListenerThread(LPVOID param)
+--
+--	RETURNS:		DWORD
+--
+--	NOTES:			Accepts clients on a port's TCP listener.
+-----------------------------------------------------------------------------------*/
+static DWORD WINAPI ListenerThread(LPVOID param) {
+	BRIDGEPORT* port = (BRIDGEPORT*)param;
+	SOCKET sock;
+
+	while ((sock = accept(port->listener, NULL, NULL)) != INVALID_SOCKET) {
+		AttachClient(port, sock);
+	}
+
+	BridgeLog("%s: listener stopped, error %d", port->name, WSAGetLastError());
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: StopBridgePort
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static void StopBridgePort(BRIDGEPORT* port)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Called by the reader when its port can no longer be read.
+--					Closes the listener, which ends the listener thread, and
+--					disconnects every client, so nobody is left attached to a
+--					dead port.
+-----------------------------------------------------------------------------------*/
+static void StopBridgePort(BRIDGEPORT* port) {
+	BridgeLog("%s: port stopped, disconnecting its clients", port->name);
+	closesocket(port->listener);
+
+	EnterCriticalSection(&port->clientLock);
+	for (int i = 0; i < BRIDGE_MAX_CLIENTS; i++) {
+		BRIDGECLIENT* client = port->clients[i];
+		if (client != NULL) {
+			EnterCriticalSection(&client->lock);
+			CloseClient(client);
+			LeaveCriticalSection(&client->lock);
+		}
+	}
+	LeaveCriticalSection(&port->clientLock);
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: ReaderThread
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - stops the port when it exits
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static DWORD WINAPI ReaderThread(LPVOID param)
+--
+--	RETURNS:		DWORD
+--
+--	NOTES:			Reads a port into shared buffers and hands each one to every
+--					attached client.  If slow clients have taken every buffer, what
+--					is read is dropped rather than leaving it in the driver queue.
+--					Exits, stopping the port, once the port cannot be read.
+-----------------------------------------------------------------------------------*/
+static DWORD WINAPI ReaderThread(LPVOID param) {
+	BRIDGEPORT* port = (BRIDGEPORT*)param;
+	OVERLAPPED ov = { 0 };
+	char scratch[BRIDGE_READ_SIZE];
+	DWORD readBytes;
+
+	// create manual reset event for asynchronous I/O
+	ov.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+	if (ov.hEvent == NULL) {
+		BridgeLog("%s: error creating reset event", port->name);
+		StopBridgePort(port);
+		return 0;
+	}
+
+	while (1) {
+		SHAREDBUF* buffer = (SHAREDBUF*)PoolAlloc(&port->buffers);
+		char* target = (buffer != NULL) ? buffer->data : scratch;
+
+		//returns as soon as anything arrives, or after READ_TIMEOUT
+		readBytes = 0;
+		if (!ReadFile(port->comm, target, BRIDGE_READ_SIZE, &readBytes, &ov)) {
+			if (GetLastError() != ERROR_IO_PENDING
+				|| !GetOverlappedResult(port->comm, &ov, &readBytes, TRUE)) {
+				BridgeLog("%s: error reading from serial port", port->name);
+				if (buffer != NULL) {
+					PoolFree(&port->buffers, buffer);
+				}
+				break;
+			}
+		}
+
+		if (buffer == NULL) {
+			port->dropped += readBytes;
+			continue;
+		}
+		if (readBytes == 0) {
+			PoolFree(&port->buffers, buffer);
+			continue;
+		}
+
+		buffer->refs = 1; // the reader's own reference
+		buffer->length = readBytes;
+		EnterCriticalSection(&port->clientLock);
+		for (int i = 0; i < BRIDGE_MAX_CLIENTS; i++) {
+			if (port->clients[i] != NULL) {
+				EnqueueBuffer(port->clients[i], buffer);
+			}
+		}
+		LeaveCriticalSection(&port->clientLock);
+		ReleaseBuffer(port, buffer);
+	}
+
+	StopBridgePort(port);
+	CloseHandle(ov.hEvent);
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: StartBridgePort
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static BOOL StartBridgePort(BRIDGEPORT* port)
+--
+--	RETURNS:		BOOL - FALSE if the port or its listener could not be set up
+--
+--	NOTES:			Opens the serial port, starts its writer and reader, and starts
+--					listening on its TCP port.
+-----------------------------------------------------------------------------------*/
+static BOOL StartBridgePort(BRIDGEPORT* port) {
+	DCB settings;
+	LPCSTR error;
+	sockaddr_in address;
+
+	if (!OpenCommPort(port->name, &port->comm, &settings, &error)) {
+		BridgeLog("%s: %s", port->name, error);
+		return false;
+	}
+	if (port->baudRate != 0) {
+		settings.BaudRate = port->baudRate;
+		if (!SetCommState(port->comm, &settings)) {
+			BridgeLog("%s: error setting %lu baud", port->name, port->baudRate);
+		}
+	}
+
+	port->listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_ANY);
+	address.sin_port = htons(port->tcpPort);
+	if (port->listener == INVALID_SOCKET
+		|| bind(port->listener, (sockaddr*)&address, sizeof(address)) == SOCKET_ERROR
+		|| listen(port->listener, SOMAXCONN) == SOCKET_ERROR) {
+		BridgeLog("%s: cannot listen on TCP port %u, error %d", port->name, port->tcpPort, WSAGetLastError());
+		if (port->listener != INVALID_SOCKET) {
+			closesocket(port->listener);
+		}
+		CloseHandle(port->comm);
+		return false;
+	}
+
+	InitWriteQueue(&port->writer, &port->writeNodes);
+	InitializeCriticalSection(&port->clientLock);
+	memset(port->clients, 0, sizeof(port->clients));
+	port->dropped = 0;
+
+	HANDLE listener = NULL;
+	if (StartWriter(&port->writer, port->comm)) {
+		port->reader = CreateThread(NULL, 0, ReaderThread, port, 0, NULL);
+		listener = CreateThread(NULL, 0, ListenerThread, port, 0, NULL);
+	}
+	if (port->reader == NULL || listener == NULL) {
+		//nothing can be cleaned up safely while either thread runs
+		BridgeLog("%s: error starting threads", port->name);
+		ExitProcess(1);
+	}
+	CloseHandle(listener);
+
+	BridgeLog("%s: bridged to TCP port %u", port->name, port->tcpPort);
+	return true;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: ParseBridgeArgs
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - numbers must be whole and in range
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static BOOL ParseBridgeArgs(LPSTR args)
+--
+--	RETURNS:		BOOL - FALSE if the arguments are not understood
+--
+--	NOTES:			Reads NAME=TCPPORT[:BAUD] port specifications and the /policy
+--					and /queue options.  A TCP port outside 1 - 65535, a zero baud
+--					rate or a number with anything after it is refused rather than
+--					quietly read as something else.
+-----------------------------------------------------------------------------------*/
+static BOOL ParseBridgeArgs(LPSTR args) {
+	char copy[1024];
+	char* context = NULL;
+	char* token;
+	char* end;
+
+	strncpy_s(copy, sizeof(copy), args, _TRUNCATE);
+	for (token = strtok_s(copy, " \t", &context); token != NULL; token = strtok_s(NULL, " \t", &context)) {
+		if (_stricmp(token, "/policy") == 0) {
+			token = strtok_s(NULL, " \t", &context);
+			if (token != NULL && _stricmp(token, "drop") == 0) {
+				slowPolicy = POLICY_DROP;
+			} else if (token != NULL && _stricmp(token, "disconnect") == 0) {
+				slowPolicy = POLICY_DISCONNECT;
+			} else {
+				return false;
+			}
+		} else if (_stricmp(token, "/queue") == 0) {
+			token = strtok_s(NULL, " \t", &context);
+			unsigned long queue = (token != NULL) ? strtoul(token, &end, 10) : 0;
+			if (queue < 1 || queue > BRIDGE_QUEUE_MAX || *end != '\0') {
+				return false;
+			}
+			queueLimit = (int)queue;
+		} else {
+			char* separator = strchr(token, '=');
+			if (separator == NULL || separator == token || bridgePortCount == BRIDGE_MAX_PORTS
+				|| separator - token >= (int)sizeof(bridgePorts[0].name)) {
+				return false;
+			}
+			BRIDGEPORT* port = &bridgePorts[bridgePortCount++];
+			*separator = '\0';
+			strcpy_s(port->name, sizeof(port->name), token);
+
+			//strtoul accepts a sign and leading blanks, digits are checked for first
+			if (!isdigit((BYTE)separator[1])) {
+				return false;
+			}
+			unsigned long tcpPort = strtoul(separator + 1, &end, 10);
+			if (tcpPort < 1 || tcpPort > 65535 || (*end != '\0' && *end != ':')) {
+				return false;
+			}
+			port->tcpPort = (USHORT)tcpPort;
+
+			port->baudRate = 0;
+			if (*end == ':') {
+				if (!isdigit((BYTE)end[1])) {
+					return false;
+				}
+				port->baudRate = strtoul(end + 1, &end, 10);
+				if (port->baudRate == 0 || *end != '\0') {
+					return false;
+				}
+			}
+		}
+	}
+	return bridgePortCount > 0;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: RunBridge
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - exits as soon as any port stops
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		int RunBridge(LPSTR args)
+--
+--	RETURNS:		int - process exit code, non-zero once a port has stopped
+--
+--	NOTES:			Entry point of headless mode, called from WinMain with the rest
+--					of the command line.  Bridges every port that can be opened and
+--					runs until one of their readers stops, then returns so the
+--					process exits and can be restarted with the port back.
+-----------------------------------------------------------------------------------*/
+int RunBridge(LPSTR args) {
+	WSADATA wsaData;
+	HANDLE readers[BRIDGE_MAX_PORTS];
+	BRIDGEPORT* started[BRIDGE_MAX_PORTS];
+	int running = 0;
+
+	OpenBridgeLog();
+
+	if (!ParseBridgeArgs(args)) {
+		BridgeLog("usage: /bridge NAME=TCPPORT[:BAUD] ... [/policy drop|disconnect] [/queue buffers]");
+		return 1;
+	}
+
+	if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+		BridgeLog("Error starting Winsock");
+		return 1;
+	}
+
+	//every port gets a pool no set of stalled clients can empty
+	SIZE_T bufferSize = (sizeof(SHAREDBUF) + MEMORY_ALLOCATION_ALIGNMENT - 1) & ~(SIZE_T)(MEMORY_ALLOCATION_ALIGNMENT - 1);
+	SIZE_T nodeSize = (sizeof(WRITENODE) + MEMORY_ALLOCATION_ALIGNMENT - 1) & ~(SIZE_T)(MEMORY_ALLOCATION_ALIGNMENT - 1);
+	bridgeArena.size = (bufferSize * BRIDGE_PORT_BUFFERS(queueLimit) + nodeSize * BRIDGE_WRITE_NODES) * bridgePortCount;
+	bridgeArena.used = 0;
+	bridgeArena.base = (BYTE*)VirtualAlloc(NULL, bridgeArena.size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+	BOOL pooled = (bridgeArena.base != NULL)
+		&& PoolInit(&clientPool, &sessionArena, sizeof(BRIDGECLIENT), BRIDGE_CLIENTS);
+	for (int i = 0; i < bridgePortCount && pooled; i++) {
+		pooled = PoolInit(&bridgePorts[i].buffers, &bridgeArena, sizeof(SHAREDBUF), BRIDGE_PORT_BUFFERS(queueLimit))
+			&& PoolInit(&bridgePorts[i].writeNodes, &bridgeArena, sizeof(WRITENODE), BRIDGE_WRITE_NODES);
+	}
+	if (!pooled) {
+		BridgeLog("Error allocating bridge pools");
+		return 1;
+	}
+
+	for (int i = 0; i < bridgePortCount; i++) {
+		if (StartBridgePort(&bridgePorts[i])) {
+			started[running] = &bridgePorts[i];
+			readers[running++] = bridgePorts[i].reader;
+		}
+	}
+
+	if (running > 0) {
+		DWORD stopped = WaitForMultipleObjects(running, readers, FALSE, INFINITE) - WAIT_OBJECT_0;
+		if (stopped < (DWORD)running) {
+			BridgeLog("%s: port lost, bridge exiting", started[stopped]->name);
+		}
+	}
+
+	WSACleanup();
+	return 1;
+}
@@ -0,0 +1,683 @@
+/*-----------------------------------------------------------------------------------
+--	SOURCE FILE:	Discovery.cpp - Finds the serial ports present on the machine
+--									and probes them in the background to fill
+--									the Port menu.
+--
+--	PROGRAM:        Terminal Emulator
+--
+--	FUNCTIONS:
+--					void DiscoverPorts(BOOL reprobe)
+--					void PortProbed(LPARAM probe)
+--					void ProbesTimedOut()
+--					void SelectPort(int index)
+--					void BuildPortMenu()
+--					BOOL CheckPortIdle(LPCSTR name)
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - port items are grayed while connected,
+--									   leaving Refresh usable, and Connect
+--									   refuses a port still being probed
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	NOTES:			Discovery.cpp is part of a minimal Windows terminal emulator,
+--					that transmits characters typed on the keyboard to the serial
+--					port and displays all characters received via the serial port.
+--
+--					Ports are listed from HKLM\HARDWARE\DEVICEMAP\SERIALCOMM, which
+--					the serial and USB serial drivers keep up to date, so listing
+--					them opens nothing.  Each port is then probed on its own thread:
+--					whether it can be opened, its current settings and, if Auto-detect
+--					Baud is on, the rate at which it answers a carriage return with
+--					readable text.  Probes post their result to the window, so the
+--					window never waits on a port.  Probes that have not finished
+--					after DISCOVERY_TIMEOUT are shown as not responding; a driver
+--					hung in CreateFile only keeps its own probe thread.
+--
+--					The list is refreshed when Windows reports a port arriving or
+--					leaving, and from the Refresh item of the Port menu.
+--
+--					All of this runs on the window thread apart from the probes
+--					themselves, which only touch their own PROBE.
+-----------------------------------------------------------------------------------*/
+
+#define STRICT
+
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "header.h"
+
+#define PORT_NAME_SIZE      16
+#define PROBE_SLOTS         (MAX_PORTS * 2)   // room for probes left behind by hung drivers
+#define PROBE_STACK_SIZE    0x10000
+#define PROBE_IO_TIMEOUT    200               // milliseconds a probe waits on one read or write
+#define PROBE_STRING        "\r"
+#define PROBE_TEXT_PERCENT  90                // printable share of a reply at the right rate
+
+// What probing found out about a port
+typedef enum {
+	PORT_PROBING,
+	PORT_READY,           // opened, settings read
+	PORT_IN_USE,          // opened by another program
+	PORT_UNAVAILABLE,     // could not be opened or read
+	PORT_NOT_RESPONDING   // probe did not finish in time
+} PORTSTATE;
+
+// A port in the Port menu
+typedef struct {
+	char name[PORT_NAME_SIZE];
+	PORTSTATE state;
+	DCB settings;         // valid when PORT_READY
+	DWORD detectedBaud;   // 0 if not detected
+} PORTINFO;
+
+// A probe handed to a probe thread and posted back to the window
+typedef struct {
+	LONG busy;            // set while the slot is owned by a probe thread
+	BOOL autoBaud;
+	PORTINFO result;
+} PROBE;
+
+// declared variables
+BOOL autoBaudEnabled = FALSE;
+DWORD detectedBaud = 0;
+static PORTINFO ports[MAX_PORTS];
+static int portCount = 0;
+static PROBE probes[PROBE_SLOTS];
+static char selectedPort[PORT_NAME_SIZE];
+static BOOL portChosen = FALSE;     // the user picked a port from the menu
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: ComparePortNames
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static int ComparePortNames(const char* a, const char* b)
+--
+--	RETURNS:		int - less than, equal to or greater than 0, like strcmp
+--
+--	NOTES:			Orders names by prefix and then by number, so COM2 comes before
+--					COM10.
+-----------------------------------------------------------------------------------*/
+static int ComparePortNames(const char* a, const char* b) {
+	size_t prefixA = strcspn(a, "0123456789");
+	size_t prefixB = strcspn(b, "0123456789");
+	int result = _strnicmp(a, b, min(prefixA, prefixB));
+
+	if (result != 0 || prefixA != prefixB) {
+		return (result != 0) ? result : (int)prefixA - (int)prefixB;
+	}
+	unsigned long numberA = strtoul(a + prefixA, NULL, 10);
+	unsigned long numberB = strtoul(b + prefixB, NULL, 10);
+	return (numberA < numberB) ? -1 : (numberA > numberB) ? 1 : 0;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: EnumeratePorts
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static int EnumeratePorts(PORTINFO found[])
+--
+--	RETURNS:		int - number of ports found, at most MAX_PORTS
+--
+--	NOTES:			Reads the names of the serial ports present from the registry,
+--					sorted.  The key does not exist while there are none.
+-----------------------------------------------------------------------------------*/
+static int EnumeratePorts(PORTINFO found[]) {
+	HKEY key;
+	int count = 0;
+
+	if (RegOpenKeyEx(HKEY_LOCAL_MACHINE, "HARDWARE\\DEVICEMAP\\SERIALCOMM", 0, KEY_READ, &key) != ERROR_SUCCESS) {
+		return 0;
+	}
+
+	for (DWORD i = 0; count < MAX_PORTS; i++) {
+		char device[256];
+		char name[PORT_NAME_SIZE];
+		DWORD deviceLength = sizeof(device);
+		DWORD nameLength = sizeof(name) - 1;
+		DWORD type;
+
+		LONG result = RegEnumValue(key, i, device, &deviceLength, NULL, &type, (BYTE*)name, &nameLength);
+		if (result == ERROR_NO_MORE_ITEMS) {
+			break;
+		}
+		if (result != ERROR_SUCCESS || type != REG_SZ) {
+			continue;
+		}
+		name[nameLength] = '\0'; // registry strings need not be terminated
+
+		//insert in order
+		int j = count++;
+		for (; j > 0 && ComparePortNames(found[j - 1].name, name) > 0; j--) {
+			found[j] = found[j - 1];
+		}
+		memset(&found[j], 0, sizeof(found[j]));
+		strcpy_s(found[j].name, sizeof(found[j].name), name);
+	}
+
+	RegCloseKey(key);
+	return count;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: ProbeIO
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static BOOL ProbeIO(HANDLE port, OVERLAPPED* ov, BOOL write,
+--						char* data, DWORD length, DWORD* done)
+--
+--	RETURNS:		BOOL - FALSE if the I/O failed or did not finish in time
+--
+--	NOTES:			Reads or writes with a bounded wait, cancelling the I/O if the
+--					device does not complete it within PROBE_IO_TIMEOUT.
+-----------------------------------------------------------------------------------*/
+static BOOL ProbeIO(HANDLE port, OVERLAPPED* ov, BOOL write, char* data, DWORD length, DWORD* done) {
+	BOOL result = write ? WriteFile(port, data, length, done, ov) : ReadFile(port, data, length, done, ov);
+
+	if (result) {
+		return true;
+	}
+	if (GetLastError() != ERROR_IO_PENDING) {
+		return false;
+	}
+	if (WaitForSingleObject(ov->hEvent, PROBE_IO_TIMEOUT) != WAIT_OBJECT_0) {
+		CancelIo(port);
+		GetOverlappedResult(port, ov, done, TRUE); // the buffer is ours again
+		return false;
+	}
+	return GetOverlappedResult(port, ov, done, FALSE);
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: DetectBaud
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static DWORD DetectBaud(HANDLE port, const DCB* settings)
+--
+--	RETURNS:		DWORD - baud rate the device answered at, or 0
+--
+--	NOTES:			Sends PROBE_STRING at each common rate, fastest first, and takes
+--					the first rate whose reply is mostly printable.  The port's own
+--					settings and timeouts are put back afterwards.
+-----------------------------------------------------------------------------------*/
+static DWORD DetectBaud(HANDLE port, const DCB* settings) {
+	static const DWORD rates[] = { 115200, 57600, 38400, 19200, 9600, 4800, 2400, 1200 };
+	OVERLAPPED ov = { 0 };
+	COMMTIMEOUTS original;
+	COMMTIMEOUTS timeouts = { MAXDWORD, MAXDWORD, PROBE_IO_TIMEOUT, 0, PROBE_IO_TIMEOUT };
+	char reply[64];
+	DWORD done;
+	DWORD found = 0;
+
+	ov.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+	if (ov.hEvent == NULL || !GetCommTimeouts(port, &original) || !SetCommTimeouts(port, &timeouts)) {
+		if (ov.hEvent != NULL) {
+			CloseHandle(ov.hEvent);
+		}
+		return 0;
+	}
+
+	for (DWORD i = 0; i < sizeof(rates) / sizeof(rates[0]) && found == 0; i++) {
+		DCB trial = *settings;
+		trial.BaudRate = rates[i];
+		if (!SetCommState(port, &trial)) {
+			continue;
+		}
+		PurgeComm(port, PURGE_RXCLEAR | PURGE_TXCLEAR);
+
+		if (!ProbeIO(port, &ov, TRUE, (char*)PROBE_STRING, sizeof(PROBE_STRING) - 1, &done)
+			|| !ProbeIO(port, &ov, FALSE, reply, sizeof(reply), &done)
+			|| done == 0) {
+			continue;
+		}
+
+		DWORD printable = 0;
+		for (DWORD j = 0; j < done; j++) {
+			if ((reply[j] >= ' ' && reply[j] <= '~') || reply[j] == '\r' || reply[j] == '\n' || reply[j] == '\t') {
+				printable++;
+			}
+		}
+		if (printable * 100 >= done * PROBE_TEXT_PERCENT) {
+			found = rates[i];
+		}
+	}
+
+	SetCommState(port, (DCB*)settings);
+	SetCommTimeouts(port, &original);
+	CloseHandle(ov.hEvent);
+	return found;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: ProbeThread
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static DWORD WINAPI ProbeThread(LPVOID param)
+--
+--	RETURNS:		DWORD
+--
+--	NOTES:			Probes one port and posts the result to the window.  Opens the
+--					port itself rather than with OpenCommPort, so nothing it has
+--					received is purged and in use can be told apart from missing.
+-----------------------------------------------------------------------------------*/
+static DWORD WINAPI ProbeThread(LPVOID param) {
+	PROBE* probe = (PROBE*)param;
+	PORTINFO* result = &probe->result;
+	char path[MAX_PATH];
+
+	sprintf_s(path, sizeof(path), "\\\\.\\%s", result->name);
+	HANDLE port = CreateFile(path, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL);
+	if (port == INVALID_HANDLE_VALUE) {
+		result->state = (GetLastError() == ERROR_ACCESS_DENIED) ? PORT_IN_USE : PORT_UNAVAILABLE;
+	} else {
+		result->settings.DCBlength = sizeof(DCB);
+		if (!GetCommState(port, &result->settings)) {
+			result->state = PORT_UNAVAILABLE;
+		} else {
+			result->state = PORT_READY;
+			if (probe->autoBaud) {
+				result->detectedBaud = DetectBaud(port, &result->settings);
+			}
+		}
+		CloseHandle(port);
+	}
+
+	if (!PostMessage(hwnd, WM_PORT_PROBED, 0, (LPARAM)probe)) {
+		InterlockedExchange(&probe->busy, 0);
+	}
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: StartProbe
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static BOOL StartProbe(const char* name)
+--
+--	RETURNS:		BOOL - FALSE if no probe could be started
+--
+--	NOTES:			Takes a free probe slot and starts a thread on it.  The thread
+--					is not waited for.
+-----------------------------------------------------------------------------------*/
+static BOOL StartProbe(const char* name) {
+	for (int i = 0; i < PROBE_SLOTS; i++) {
+		PROBE* probe = &probes[i];
+		if (InterlockedCompareExchange(&probe->busy, 1, 0) != 0) {
+			continue;
+		}
+
+		memset(&probe->result, 0, sizeof(probe->result));
+		strcpy_s(probe->result.name, sizeof(probe->result.name), name);
+		probe->result.state = PORT_PROBING;
+		probe->autoBaud = autoBaudEnabled;
+
+		HANDLE thread = CreateThread(NULL, PROBE_STACK_SIZE, ProbeThread, probe, STACK_SIZE_PARAM_IS_A_RESERVATION, NULL);
+		if (thread == NULL) {
+			InterlockedExchange(&probe->busy, 0);
+			return false;
+		}
+		CloseHandle(thread);
+		return true;
+	}
+	OutputDebugString("no free port probes");
+	return false;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: FindPort
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static int FindPort(const char* name)
+--
+--	RETURNS:		int - index into ports, or -1 if the port is not listed
+-----------------------------------------------------------------------------------*/
+static int FindPort(const char* name) {
+	for (int i = 0; i < portCount; i++) {
+		if (_stricmp(ports[i].name, name) == 0) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: UsePort
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static void UsePort(int index)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Makes a listed port the one Connect opens.
+-----------------------------------------------------------------------------------*/
+static void UsePort(int index) {
+	strcpy_s(selectedPort, sizeof(selectedPort), ports[index].name);
+	lpszCommName = selectedPort;
+	detectedBaud = ports[index].detectedBaud;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: BuildPortMenu
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - grays the ports while connected
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void BuildPortMenu()
+--
+--	RETURNS:		void
+--
+--	NOTES:			Fills the Port menu with the listed ports and what is known
+--					about them, checking the selected one.  While connected the
+--					ports are grayed so the port cannot change under the session,
+--					but Refresh stays usable.
+-----------------------------------------------------------------------------------*/
+void BuildPortMenu() {
+	HMENU menu = GetSubMenu(GetMenu(hwnd), PORT_MENU);
+	char label[96];
+
+	while (GetMenuItemCount(menu) > 0) {
+		DeleteMenu(menu, 0, MF_BYPOSITION);
+	}
+
+	for (int i = 0; i < portCount; i++) {
+		PORTINFO* port = &ports[i];
+		switch (port->state) {
+		case PORT_PROBING:
+			sprintf_s(label, sizeof(label), "%s\tprobing...", port->name);
+			break;
+		case PORT_READY:
+			sprintf_s(label, sizeof(label), "%s\t%lu %d%c%s", port->name,
+				port->settings.BaudRate, port->settings.ByteSize,
+				"NOEMS"[port->settings.Parity % 5],
+				(port->settings.StopBits == TWOSTOPBITS) ? "2" : (port->settings.StopBits == ONE5STOPBITS) ? "1.5" : "1");
+			if (port->detectedBaud != 0 && port->detectedBaud != port->settings.BaudRate) {
+				sprintf_s(label + strlen(label), sizeof(label) - strlen(label), ", answers at %lu", port->detectedBaud);
+			}
+			break;
+		case PORT_IN_USE:
+			sprintf_s(label, sizeof(label), "%s\tin use", port->name);
+			break;
+		case PORT_UNAVAILABLE:
+			sprintf_s(label, sizeof(label), "%s\tunavailable", port->name);
+			break;
+		case PORT_NOT_RESPONDING:
+			sprintf_s(label, sizeof(label), "%s\tnot responding", port->name);
+			break;
+		}
+		BOOL selected = (_stricmp(port->name, lpszCommName) == 0);
+		AppendMenu(menu, MF_STRING | (selected ? MF_CHECKED : MF_UNCHECKED) | (connected ? MF_GRAYED : MF_ENABLED),
+			IDM_PORT_BASE + i, label);
+	}
+
+	if (portCount == 0) {
+		AppendMenu(menu, MF_STRING | MF_GRAYED, 0, "No ports found");
+	}
+	AppendMenu(menu, MF_SEPARATOR, 0, NULL);
+	AppendMenu(menu, MF_STRING, IDM_RefreshPorts, "&Refresh");
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: DiscoverPorts
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void DiscoverPorts(BOOL reprobe)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Lists the ports present and starts probes without waiting for
+--					them.  Ports already listed keep what is known about them unless
+--					reprobe is set or they were not usable last time.  The connected
+--					port and ports whose probe is still running are never probed
+--					again.
+-----------------------------------------------------------------------------------*/
+void DiscoverPorts(BOOL reprobe) {
+	PORTINFO found[MAX_PORTS];
+	int count = EnumeratePorts(found);
+	BOOL probing = FALSE;
+
+	for (int i = 0; i < count; i++) {
+		int known = FindPort(found[i].name);
+		BOOL active = (connected && _stricmp(found[i].name, lpszCommName) == 0);
+
+		if (known >= 0 && (active || ports[known].state == PORT_PROBING
+			|| ports[known].state == PORT_NOT_RESPONDING
+			|| (!reprobe && ports[known].state == PORT_READY))) {
+			found[i] = ports[known];
+		} else if (active) {
+			found[i].state = PORT_IN_USE;
+		} else {
+			found[i].state = StartProbe(found[i].name) ? PORT_PROBING : PORT_UNAVAILABLE;
+		}
+		probing = probing || (found[i].state == PORT_PROBING);
+	}
+
+	memcpy(ports, found, count * sizeof(PORTINFO));
+	portCount = count;
+	BuildPortMenu();
+
+	if (probing) {
+		SetTimer(hwnd, IDT_DISCOVERY, DISCOVERY_TIMEOUT, NULL);
+	}
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: PortProbed
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void PortProbed(LPARAM probe)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Handles WM_PORT_PROBED.  Records the result if the port is still
+--					listed and frees the probe slot.  Until the user picks a port,
+--					the first usable one found replaces a default that is not.
+-----------------------------------------------------------------------------------*/
+void PortProbed(LPARAM probe) {
+	PROBE* finished = (PROBE*)probe;
+	int i = FindPort(finished->result.name);
+
+	if (i >= 0) {
+		ports[i] = finished->result;
+	}
+	InterlockedExchange(&finished->busy, 0);
+	if (i < 0) {
+		return;
+	}
+
+	if (!portChosen && !connected && ports[i].state == PORT_READY) {
+		int current = FindPort(lpszCommName);
+		if (current < 0 || current == i || ports[current].state != PORT_READY) {
+			UsePort(i);
+		}
+	}
+	BuildPortMenu();
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: ProbesTimedOut
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void ProbesTimedOut()
+--
+--	RETURNS:		void
+--
+--	NOTES:			Handles IDT_DISCOVERY.  Shows ports whose probe is still running
+--					as not responding.  A late result still replaces this.
+-----------------------------------------------------------------------------------*/
+void ProbesTimedOut() {
+	KillTimer(hwnd, IDT_DISCOVERY);
+	for (int i = 0; i < portCount; i++) {
+		if (ports[i].state == PORT_PROBING) {
+			ports[i].state = PORT_NOT_RESPONDING;
+		}
+	}
+	BuildPortMenu();
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: SelectPort
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void SelectPort(int index)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Handles a port picked from the Port menu, warning straight away
+--					if the probe found it cannot be used.
+-----------------------------------------------------------------------------------*/
+void SelectPort(int index) {
+	char message[96];
+
+	if (index < 0 || index >= portCount || connected) {
+		return;
+	}
+	UsePort(index);
+	portChosen = TRUE;
+	BuildPortMenu();
+
+	switch (ports[index].state) {
+	case PORT_IN_USE:
+		sprintf_s(message, sizeof(message), "Port set to %s, but it is in use by another program", selectedPort);
+		break;
+	case PORT_UNAVAILABLE:
+	case PORT_NOT_RESPONDING:
+		sprintf_s(message, sizeof(message), "Port set to %s, but it could not be opened", selectedPort);
+		break;
+	default:
+		sprintf_s(message, sizeof(message), "Port set to %s", selectedPort);
+		break;
+	}
+	MessageBox(hwnd, message, "", MB_OK);
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: CheckPortIdle
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		BOOL CheckPortIdle(LPCSTR name)
+--
+--	RETURNS:		BOOL - FALSE if a probe still has the port open
+--
+--	NOTES:			Called by Connect.  A probe opens its port exclusively, so
+--					opening the port while one runs would fail; instead the user is
+--					told to try again once the probe is done.  Probes left behind
+--					by a hung driver count as well, for as long as they hold on.
+-----------------------------------------------------------------------------------*/
+BOOL CheckPortIdle(LPCSTR name) {
+	char message[96];
+
+	for (int i = 0; i < PROBE_SLOTS; i++) {
+		if (probes[i].busy && _stricmp(probes[i].result.name, name) == 0) {
+			int known = FindPort(name);
+			if (known >= 0 && ports[known].state == PORT_NOT_RESPONDING) {
+				sprintf_s(message, sizeof(message), "%s is not responding, try again later", name);
+			} else {
+				sprintf_s(message, sizeof(message), "%s is still being checked, try again in a moment", name);
+			}
+			MessageBox(hwnd, message, "", MB_OK);
+			return false;
+		}
+	}
+	return true;
+}
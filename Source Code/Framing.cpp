@@ -0,0 +1,717 @@
+/*-----------------------------------------------------------------------------------
+--	SOURCE FILE:	Framing.cpp - COBS and SLIP framing of the terminal emulator,
+--								  splitting the receive stream into packets and
+--								  framing typed payloads.
+--
+--	PROGRAM:        Terminal Emulator
+--
+--	FUNCTIONS:
+--					void InitFraming()
+--					void StartFraming()
+--					void FrameInput(char data[], DWORD length)
+--					void FrameKeystroke(char c)
+--					void SetFraming(FRAMING mode)
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - times packets with the analyzer's clock,
+--									   and framing and the analyzer exclude
+--									   each other
+--					October 19, 2026 - the payload being typed is shown in the
+--									   title bar
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	NOTES:			Framing.cpp is part of a minimal Windows terminal emulator,
+--					that transmits characters typed on the keyboard to the serial
+--					port and displays all characters received via the serial port.
+--
+--					In framing mode the read thread hands each read to FrameInput
+--					instead of printing it.  Delimiters (0x00 for COBS, END for
+--					SLIP) are found sixteen bytes at a time with SSE2 compares, and
+--					every packet that lies wholly inside the read is decoded where
+--					it is, in the receive buffer.  Only a packet split across reads
+--					is copied, into a carry buffer carved out of the session arena
+--					at startup.  Decoding never allocates.
+--
+--					The last two bytes of a packet are taken to be its CRC-16/CCITT
+--					(polynomial 0x1021, initial value 0xFFFF), most significant
+--					byte first.  Each packet is listed on the screen with the time
+--					of the read it completed in, its decoded length, CRC status and
+--					first bytes.  The lines of one read are printed together.
+--
+--					Typed characters are collected into a payload instead of being
+--					sent.  Enter appends the CRC, frames the payload and queues it
+--					on the terminal's write queue.  \xNN in the payload stands for
+--					the byte NN and \\ for a backslash.  Since nothing is echoed,
+--					the payload is shown in the title bar as it is typed.
+--
+--					This layer belongs with the Physical layer, alongside the
+--					analyzer.  Only one of them can be on at a time, since both
+--					take over the read thread; turning one on turns the other off.
+-----------------------------------------------------------------------------------*/
+
+#define STRICT
+
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <intrin.h>
+#include <emmintrin.h>
+#include "header.h"
+
+#define FRAME_MAX           0x10000   // bytes of a packet carried across reads
+#define FRAME_SHOWN_BYTES   16        // bytes of a packet printed in hex
+#define FRAME_LINE_MAX      (80 + FRAME_SHOWN_BYTES * 3)
+#define FRAME_LISTING_SIZE  8192      // listing printed at the end of each read
+#define FRAME_PAYLOAD_MAX   1024      // bytes typed into one outgoing payload
+#define FRAME_CRC_SIZE      2
+#define FRAME_TITLE         "DumbTerminal"
+#define FRAME_TITLE_SHOWN   48        // last typed characters shown in the title
+#define FRAME_ENCODED_MAX   ((FRAME_PAYLOAD_MAX + FRAME_CRC_SIZE) * 2 + 2)
+
+#define COBS_DELIMITER      0x00
+#define SLIP_END            0xC0
+#define SLIP_ESC            0xDB
+#define SLIP_ESC_END        0xDC
+#define SLIP_ESC_ESC        0xDD
+
+// declared variables
+FRAMING framingMode = FRAMING_OFF;
+static WORD crcTable[256];
+static BYTE* carry;                             // start of a packet split across reads
+static DWORD carryLength;
+static DWORD carryDropped;                      // bytes of an oversized packet thrown away
+static char listing[FRAME_LISTING_SIZE];       // lines for the current read
+static DWORD listingLength;
+static LONGLONG sessionStart;                   // counter at connect
+static char payload[FRAME_PAYLOAD_MAX];        // typed, not yet sent
+static DWORD payloadLength;
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: FindByte
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static BYTE* FindByte(BYTE* p, BYTE* end, BYTE value)
+--
+--	RETURNS:		BYTE* - the first byte equal to value, or end
+--
+--	NOTES:			Compares sixteen bytes per step and takes the first match from
+--					the compare mask.  The tail shorter than a step is scanned one
+--					byte at a time.
+-----------------------------------------------------------------------------------*/
+static BYTE* FindByte(BYTE* p, BYTE* end, BYTE value) {
+	__m128i pattern = _mm_set1_epi8((char)value);
+
+	while (end - p >= 16) {
+		int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)p), pattern));
+		if (mask != 0) {
+			unsigned long first;
+			_BitScanForward(&first, mask);
+			return p + first;
+		}
+		p += 16;
+	}
+	while (p < end && *p != value) {
+		p++;
+	}
+	return p;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: Crc16
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static WORD Crc16(const BYTE* data, DWORD length)
+--
+--	RETURNS:		WORD - CRC-16/CCITT of the data
+-----------------------------------------------------------------------------------*/
+static WORD Crc16(const BYTE* data, DWORD length) {
+	WORD crc = 0xFFFF;
+
+	for (DWORD i = 0; i < length; i++) {
+		crc = (WORD)((crc << 8) ^ crcTable[((crc >> 8) ^ data[i]) & 0xFF]);
+	}
+	return crc;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: CobsDecode
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static int CobsDecode(BYTE* data, DWORD length)
+--
+--	RETURNS:		int - decoded length, or -1 if the packet is not valid COBS
+--
+--	NOTES:			Decodes a packet without its delimiter in place.  Each block is
+--					moved down over its code byte, so the output never overtakes
+--					the input.
+-----------------------------------------------------------------------------------*/
+static int CobsDecode(BYTE* data, DWORD length) {
+	DWORD in = 0;
+	DWORD out = 0;
+
+	while (in < length) {
+		BYTE code = data[in++];
+		DWORD run = code - 1;
+		if (code == 0 || run > length - in) {
+			return -1;
+		}
+		memmove(data + out, data + in, run);
+		out += run;
+		in += run;
+		if (code != 0xFF && in < length) {
+			data[out++] = 0;
+		}
+	}
+	return out;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: SlipDecode
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static int SlipDecode(BYTE* data, DWORD length)
+--
+--	RETURNS:		int - decoded length, or -1 if an escape is not valid
+--
+--	NOTES:			Decodes a packet without its END in place.  Runs between
+--					escapes are found with FindByte, so a packet without escapes
+--					is scanned once and not moved at all.
+-----------------------------------------------------------------------------------*/
+static int SlipDecode(BYTE* data, DWORD length) {
+	BYTE* in = data;
+	BYTE* out = data;
+	BYTE* end = data + length;
+
+	while (1) {
+		BYTE* escape = FindByte(in, end, SLIP_ESC);
+		if (out != in) {
+			memmove(out, in, escape - in);
+		}
+		out += escape - in;
+		if (escape == end) {
+			break;
+		}
+		if (escape + 1 == end) {
+			return -1;
+		}
+		if (escape[1] == SLIP_ESC_END) {
+			*out++ = SLIP_END;
+		} else if (escape[1] == SLIP_ESC_ESC) {
+			*out++ = SLIP_ESC;
+		} else {
+			return -1;
+		}
+		in = escape + 2;
+	}
+	return (int)(out - data);
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: CobsEncode
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static DWORD CobsEncode(const BYTE* data, DWORD length,
+--						BYTE* out)
+--
+--	RETURNS:		DWORD - encoded length, including the delimiter
+-----------------------------------------------------------------------------------*/
+static DWORD CobsEncode(const BYTE* data, DWORD length, BYTE* out) {
+	DWORD codeAt = 0;
+	DWORD used = 1;
+	BYTE code = 1;
+
+	for (DWORD i = 0; i < length; i++) {
+		if (data[i] == 0) {
+			out[codeAt] = code;
+			codeAt = used++;
+			code = 1;
+		} else {
+			out[used++] = data[i];
+			if (++code == 0xFF) {
+				out[codeAt] = code;
+				codeAt = used++;
+				code = 1;
+			}
+		}
+	}
+	out[codeAt] = code;
+	out[used++] = COBS_DELIMITER;
+	return used;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: SlipEncode
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static DWORD SlipEncode(const BYTE* data, DWORD length,
+--						BYTE* out)
+--
+--	RETURNS:		DWORD - encoded length, including both ENDs
+--
+--	NOTES:			Starts with END as well, so line noise before the packet is
+--					ended as a packet of its own.
+-----------------------------------------------------------------------------------*/
+static DWORD SlipEncode(const BYTE* data, DWORD length, BYTE* out) {
+	DWORD used = 0;
+
+	out[used++] = SLIP_END;
+	for (DWORD i = 0; i < length; i++) {
+		if (data[i] == SLIP_END) {
+			out[used++] = SLIP_ESC;
+			out[used++] = SLIP_ESC_END;
+		} else if (data[i] == SLIP_ESC) {
+			out[used++] = SLIP_ESC;
+			out[used++] = SLIP_ESC_ESC;
+		} else {
+			out[used++] = data[i];
+		}
+	}
+	out[used++] = SLIP_END;
+	return used;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: FormatPacket
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static int FormatPacket(char* line, LONGLONG when,
+--						const char* direction, DWORD length, const char* status,
+--						const BYTE* data)
+--
+--	RETURNS:		int - length of the line
+--
+--	NOTES:			Formats one listing line into a buffer of FRAME_LINE_MAX.  data
+--					is NULL for a packet that could not be decoded.
+-----------------------------------------------------------------------------------*/
+static int FormatPacket(char* line, LONGLONG when, const char* direction, DWORD length,
+						const char* status, const BYTE* data) {
+	static const char hex[] = "0123456789ABCDEF";
+	LONGLONG us = TicksToMicros(when - sessionStart);
+
+	int used = sprintf_s(line, FRAME_LINE_MAX, "%9lld.%03lld ms  %s %s  len %5lu  %-8s",
+		us / 1000, us % 1000, direction, (framingMode == FRAMING_COBS) ? "COBS" : "SLIP", length, status);
+
+	if (data != NULL) {
+		line[used++] = ':';
+		for (DWORD i = 0; i < length && i < FRAME_SHOWN_BYTES; i++) {
+			line[used++] = ' ';
+			line[used++] = hex[data[i] >> 4];
+			line[used++] = hex[data[i] & 0xF];
+		}
+		if (length > FRAME_SHOWN_BYTES) {
+			line[used++] = ' ';
+			line[used++] = '.';
+			line[used++] = '.';
+			line[used++] = '.';
+		}
+	}
+	line[used++] = '\r';
+	line[used++] = '\n';
+	return used;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: ListPacket
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static void ListPacket(LONGLONG when, DWORD length,
+--						const char* status, const BYTE* data)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Adds a received packet to the listing of the current read,
+--					printing the listing first if it is full.
+-----------------------------------------------------------------------------------*/
+static void ListPacket(LONGLONG when, DWORD length, const char* status, const BYTE* data) {
+	if (listingLength + FRAME_LINE_MAX > sizeof(listing)) {
+		PrintListing(listing, listingLength);
+		listingLength = 0;
+	}
+	listingLength += FormatPacket(listing + listingLength, when, "RX", length, status, data);
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: DecodePacket
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static void DecodePacket(BYTE* data, DWORD length, LONGLONG when)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Decodes a packet in place, checks its CRC and lists it.  Empty
+--					packets, such as the END that opens a SLIP packet, are skipped.
+-----------------------------------------------------------------------------------*/
+static void DecodePacket(BYTE* data, DWORD length, LONGLONG when) {
+	if (length == 0) {
+		return;
+	}
+
+	int decoded = (framingMode == FRAMING_COBS) ? CobsDecode(data, length) : SlipDecode(data, length);
+	if (decoded < 0) {
+		ListPacket(when, length, (framingMode == FRAMING_COBS) ? "bad COBS" : "bad SLIP", NULL);
+		return;
+	}
+
+	const char* status = "short";
+	if (decoded > FRAME_CRC_SIZE) {
+		WORD received = (WORD)((data[decoded - 2] << 8) | data[decoded - 1]);
+		status = (Crc16(data, decoded - FRAME_CRC_SIZE) == received) ? "crc ok" : "crc BAD";
+	}
+	ListPacket(when, decoded, status, data);
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: InitFraming
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - starts the clock
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void InitFraming()
+--
+--	RETURNS:		void
+--
+--	NOTES:			Carves the carry buffer out of the session arena, builds the
+--					CRC table and starts the clock.  Called once at startup, after
+--					InitAnalyzer.
+-----------------------------------------------------------------------------------*/
+void InitFraming() {
+	LARGE_INTEGER counter;
+
+	//packets sent before any framed session are timed from startup
+	QueryPerformanceCounter(&counter);
+	sessionStart = counter.QuadPart;
+
+	carry = (BYTE*)ArenaAlloc(&sessionArena, FRAME_MAX);
+	if (carry == NULL) {
+		MessageBox(NULL, "Error allocating the framing buffer", "", MB_OK);
+		ExitProcess(1);
+	}
+
+	for (int i = 0; i < 256; i++) {
+		WORD crc = (WORD)(i << 8);
+		for (int bit = 0; bit < 8; bit++) {
+			crc = (WORD)((crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1);
+		}
+		crcTable[i] = crc;
+	}
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: StartFraming
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void StartFraming()
+--
+--	RETURNS:		void
+--
+--	NOTES:			Called by the read thread when a session starts in framing
+--					mode.  Forgets any partial packet and restarts the clock.
+-----------------------------------------------------------------------------------*/
+void StartFraming() {
+	LARGE_INTEGER counter;
+
+	QueryPerformanceCounter(&counter);
+	sessionStart = counter.QuadPart;
+
+	carryLength = 0;
+	carryDropped = 0;
+	listingLength = 0;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: FrameInput
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void FrameInput(char data[], DWORD length)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Called by the read thread with each read in framing mode.
+--					Splits it on delimiters, decodes the packets it ends and
+--					carries over the packet it starts.  The data is overwritten.
+-----------------------------------------------------------------------------------*/
+void FrameInput(char data[], DWORD length) {
+	BYTE delimiter = (framingMode == FRAMING_COBS) ? COBS_DELIMITER : SLIP_END;
+	BYTE* p = (BYTE*)data;
+	BYTE* end = p + length;
+	LARGE_INTEGER now;
+
+	QueryPerformanceCounter(&now);
+
+	while (p < end) {
+		BYTE* found = FindByte(p, end, delimiter);
+		DWORD run = (DWORD)(found - p);
+
+		//a packet already started, or one that is not ended yet, goes to the carry
+		if (carryLength > 0 || carryDropped > 0 || found == end) {
+			if (run > FRAME_MAX - carryLength) {
+				carryDropped += run;
+			} else {
+				memcpy(carry + carryLength, p, run);
+				carryLength += run;
+			}
+			if (found == end) {
+				break;
+			}
+			if (carryDropped > 0) {
+				ListPacket(now.QuadPart, carryLength + carryDropped, "too long", NULL);
+			} else {
+				DecodePacket(carry, carryLength, now.QuadPart);
+			}
+			carryLength = 0;
+			carryDropped = 0;
+		} else {
+			DecodePacket(p, run, now.QuadPart);
+		}
+		p = found + 1;
+	}
+
+	if (listingLength > 0) {
+		PrintListing(listing, listingLength);
+		listingLength = 0;
+	}
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: SendPayload
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static BOOL SendPayload()
+--
+--	RETURNS:		BOOL - FALSE if the packet could not be queued
+--
+--	NOTES:			Turns the typed payload into bytes, appends its CRC, frames it
+--					and queues it for the writer thread.  Lists it like a received
+--					packet.
+-----------------------------------------------------------------------------------*/
+static BOOL SendPayload() {
+	BYTE raw[FRAME_PAYLOAD_MAX + FRAME_CRC_SIZE];
+	BYTE encoded[FRAME_ENCODED_MAX];
+	char line[FRAME_LINE_MAX];
+	DWORD length = 0;
+	LARGE_INTEGER now;
+
+	for (DWORD i = 0; i < payloadLength; i++) {
+		if (payload[i] == '\\' && i + 1 < payloadLength && payload[i + 1] == '\\') {
+			raw[length++] = '\\';
+			i++;
+		} else if (payload[i] == '\\' && i + 3 < payloadLength && payload[i + 1] == 'x'
+			&& isxdigit((BYTE)payload[i + 2]) && isxdigit((BYTE)payload[i + 3])) {
+			char digits[3] = { payload[i + 2], payload[i + 3], '\0' };
+			raw[length++] = (BYTE)strtoul(digits, NULL, 16);
+			i += 3;
+		} else {
+			raw[length++] = (BYTE)payload[i];
+		}
+	}
+
+	WORD crc = Crc16(raw, length);
+	raw[length++] = (BYTE)(crc >> 8);
+	raw[length++] = (BYTE)(crc & 0xFF);
+
+	DWORD encodedLength = (framingMode == FRAMING_COBS) ? CobsEncode(raw, length, encoded) : SlipEncode(raw, length, encoded);
+	if (!QueueWrite(&terminalWriter, (const char*)encoded, encodedLength)) {
+		MessageBox(hwnd, "Packet not sent", "", MB_OK);
+		return false;
+	}
+
+	QueryPerformanceCounter(&now);
+	PrintListing(line, FormatPacket(line, now.QuadPart, "TX", length, "sent", raw));
+	return true;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: ShowPayload
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static void ShowPayload()
+--
+--	RETURNS:		void
+--
+--	NOTES:			Shows the end of the payload typed so far in the title bar,
+--					with unprintable characters as dots, or just the program name
+--					when framing is off.
+-----------------------------------------------------------------------------------*/
+static void ShowPayload() {
+	char title[sizeof(FRAME_TITLE) + FRAME_TITLE_SHOWN + 32];
+
+	if (framingMode == FRAMING_OFF) {
+		SetWindowText(hwnd, FRAME_TITLE);
+		return;
+	}
+
+	DWORD start = (payloadLength > FRAME_TITLE_SHOWN) ? payloadLength - FRAME_TITLE_SHOWN : 0;
+	int used = sprintf_s(title, sizeof(title), "%s - %s packet: %s", FRAME_TITLE,
+		(framingMode == FRAMING_COBS) ? "COBS" : "SLIP", (start > 0) ? "..." : "");
+	for (DWORD i = start; i < payloadLength; i++) {
+		title[used++] = isprint((BYTE)payload[i]) ? payload[i] : '.';
+	}
+	title[used] = '\0';
+	SetWindowText(hwnd, title);
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: FrameKeystroke
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - shows the payload, and keeps it when it
+--									   cannot be sent
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void FrameKeystroke(char c)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Called by the window for each character typed in framing mode.
+--					Builds up the payload, sending it on Enter.  Backspace removes
+--					the last character.  A payload that cannot be sent is kept, so
+--					Enter can be pressed again once connected.
+-----------------------------------------------------------------------------------*/
+void FrameKeystroke(char c) {
+	if (c == '\b') {
+		if (payloadLength > 0) {
+			payloadLength--;
+		}
+	} else if (c == '\r') {
+		if (!connected) {
+			MessageBox(hwnd, "Not connected, packet not sent", "", MB_OK);
+		} else if (SendPayload()) {
+			payloadLength = 0;
+		}
+	} else if (payloadLength < FRAME_PAYLOAD_MAX) {
+		payload[payloadLength++] = c;
+	} else {
+		MessageBeep(MB_OK); // payload full
+	}
+	ShowPayload();
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: SetFraming
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void SetFraming(FRAMING mode)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Called by the window to change the framing mode.  Starts a new
+--					payload and updates the title bar to match.
+-----------------------------------------------------------------------------------*/
+void SetFraming(FRAMING mode) {
+	framingMode = mode;
+	payloadLength = 0;
+	ShowPayload();
+}
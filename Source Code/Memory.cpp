@@ -0,0 +1,280 @@
+/*-----------------------------------------------------------------------------------
+--	SOURCE FILE:	Memory.cpp - Memory management of the terminal emulator,
+--								 carving all session data out of one arena that
+--								 is allocated at startup.
+--
+--	PROGRAM:        Terminal Emulator
+--
+--	FUNCTIONS:
+--					void InitMemory()
+--					void* ArenaAlloc(ARENA* arena, SIZE_T size)
+--					BOOL PoolInit(POOL* pool, ARENA* arena, SIZE_T blockSize,
+--						DWORD count)
+--					void* PoolAlloc(POOL* pool)
+--					void PoolFree(POOL* pool, void* block)
+--					void CheckSteadyState(DWORD receivedBytes)
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	NOTES:			Memory.cpp is part of a minimal Windows terminal emulator,
+--					that transmits characters typed on the keyboard to the serial
+--					port and displays all characters received via the serial port.
+--
+--					The session arena is reserved and committed in one VirtualAlloc
+--					call when the program starts.  The scrollback is carved out of
+--					it directly, and receive buffers and write queue nodes come
+--					from fixed size pools carved out of it.  Nothing is returned to
+--					the arena, so the memory used by a session stays flat however
+--					long it runs.
+--
+--					Pools keep their free blocks on an interlocked singly linked
+--					list, so any thread can take and return blocks without a lock.
+--
+--					Debug builds install a CRT allocation hook that counts heap
+--					allocations per thread.  The read thread calls CheckSteadyState
+--					after every read, which asserts that no allocation was made
+--					once the session has warmed up.
+-----------------------------------------------------------------------------------*/
+
+#define STRICT
+
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "header.h"
+
+#ifdef _DEBUG
+#include <crtdbg.h>
+#endif
+
+#define ARENA_ALIGNMENT   MEMORY_ALLOCATION_ALIGNMENT
+#define WARMUP_BYTES      4096     // bytes received before allocations are checked
+
+// declared variables
+ARENA sessionArena;
+POOL rxPool;
+POOL writePool;
+
+#ifdef _DEBUG
+static __declspec(thread) LONG threadAllocations = 0;   // heap allocations by this thread
+static __declspec(thread) LONG warmAllocations = 0;     // count when warm up ended
+static __declspec(thread) DWORD warmBytes = 0;          // bytes received while warming up
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: AllocHook
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static int AllocHook(int allocType, void* userData, size_t size,
+--						int blockType, long requestNumber,
+--						const unsigned char* filename, int lineNumber)
+--
+--	RETURNS:		int - TRUE to let the allocation go ahead
+--
+--	NOTES:			Called by the debug CRT for every malloc, realloc and new.
+-----------------------------------------------------------------------------------*/
+static int AllocHook(int allocType, void* userData, size_t size, int blockType,
+					 long requestNumber, const unsigned char* filename, int lineNumber) {
+	if (allocType != _HOOK_FREE) {
+		threadAllocations++;
+	}
+	return TRUE;
+}
+#endif
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: InitMemory
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void InitMemory()
+--
+--	RETURNS:		void
+--
+--	NOTES:			Allocates the session arena and carves the pools out of it.
+--					Must be called before anything else is carved out of it.
+-----------------------------------------------------------------------------------*/
+void InitMemory() {
+	sessionArena.base = (BYTE*)VirtualAlloc(NULL, SESSION_ARENA_SIZE, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+	sessionArena.size = SESSION_ARENA_SIZE;
+	sessionArena.used = 0;
+	if (sessionArena.base == NULL) {
+		MessageBox(NULL, "Error allocating session memory", "", MB_OK);
+		ExitProcess(1);
+	}
+
+	if (!PoolInit(&rxPool, &sessionArena, RX_BUFFER_SIZE, RX_BUFFERS)
+		|| !PoolInit(&writePool, &sessionArena, sizeof(WRITENODE), WRITE_NODES)) {
+		MessageBox(NULL, "Error allocating session pools", "", MB_OK);
+		ExitProcess(1);
+	}
+
+#ifdef _DEBUG
+	_CrtSetAllocHook(AllocHook);
+#endif
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: ArenaAlloc
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void* ArenaAlloc(ARENA* arena, SIZE_T size)
+--
+--	RETURNS:		void* - aligned block of the arena, or NULL if it is used up
+--
+--	NOTES:			Hands out the next part of the arena.  Blocks are never freed.
+-----------------------------------------------------------------------------------*/
+void* ArenaAlloc(ARENA* arena, SIZE_T size) {
+	SIZE_T start = (arena->used + ARENA_ALIGNMENT - 1) & ~(SIZE_T)(ARENA_ALIGNMENT - 1);
+
+	if (start > arena->size || size > arena->size - start) {
+		OutputDebugString("session arena used up");
+		return NULL;
+	}
+	arena->used = start + size;
+	return arena->base + start;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: PoolInit
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		BOOL PoolInit(POOL* pool, ARENA* arena, SIZE_T blockSize,
+--						DWORD count)
+--
+--	RETURNS:		BOOL - FALSE if the arena could not hold the pool
+--
+--	NOTES:			Carves count blocks of blockSize out of the arena and puts them
+--					all on the free list.
+-----------------------------------------------------------------------------------*/
+BOOL PoolInit(POOL* pool, ARENA* arena, SIZE_T blockSize, DWORD count) {
+	blockSize = (blockSize + ARENA_ALIGNMENT - 1) & ~(SIZE_T)(ARENA_ALIGNMENT - 1);
+	if (blockSize < sizeof(SLIST_ENTRY)) {
+		blockSize = sizeof(SLIST_ENTRY);
+	}
+
+	BYTE* blocks = (BYTE*)ArenaAlloc(arena, blockSize * count);
+	if (blocks == NULL) {
+		return false;
+	}
+
+	InitializeSListHead(&pool->freeBlocks);
+	pool->blockSize = blockSize;
+	for (DWORD i = 0; i < count; i++) {
+		InterlockedPushEntrySList(&pool->freeBlocks, (PSLIST_ENTRY)(blocks + i * blockSize));
+	}
+	return true;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: PoolAlloc
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void* PoolAlloc(POOL* pool)
+--
+--	RETURNS:		void* - a free block, or NULL if the pool is empty
+--
+--	NOTES:			The pool never grows, so callers must cope with NULL.
+-----------------------------------------------------------------------------------*/
+void* PoolAlloc(POOL* pool) {
+	return InterlockedPopEntrySList(&pool->freeBlocks);
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: PoolFree
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void PoolFree(POOL* pool, void* block)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Returns a block taken from the pool.
+-----------------------------------------------------------------------------------*/
+void PoolFree(POOL* pool, void* block) {
+	InterlockedPushEntrySList(&pool->freeBlocks, (PSLIST_ENTRY)block);
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: CheckSteadyState
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void CheckSteadyState(DWORD receivedBytes)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Called by the read thread after each read.  In debug builds,
+--					once WARMUP_BYTES have been received, asserts that the thread
+--					has not allocated from the heap since.  Does nothing in release
+--					builds.
+-----------------------------------------------------------------------------------*/
+void CheckSteadyState(DWORD receivedBytes) {
+#ifdef _DEBUG
+	if (warmBytes < WARMUP_BYTES) {
+		warmBytes += receivedBytes;
+		warmAllocations = threadAllocations;
+		return;
+	}
+
+	if (threadAllocations != warmAllocations) {
+		char message[128];
+		sprintf_s(message, sizeof(message), "%ld heap allocations on the receive path",
+			threadAllocations - warmAllocations);
+		OutputDebugString(message);
+		_ASSERTE(threadAllocations == warmAllocations);
+		warmAllocations = threadAllocations;
+	}
+#endif
+}
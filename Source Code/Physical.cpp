@@ -9,11 +9,24 @@
 --	FUNCTIONS:
 --					DWORD WINAPI MonitorInputThread(LPVOID hwnd)
 --					void WriteToSerial(WPARAM wParam)
+--					void InitWriteQueue(WRITEQUEUE* queue, POOL* pool)
+--					BOOL QueueWrite(WRITEQUEUE* queue, const char* data, DWORD length)
+--					BOOL StartWriter(WRITEQUEUE* queue, HANDLE port)
+--					void StopWriter(WRITEQUEUE* queue)
+--					BOOL OpenCommPort(LPCSTR name, HANDLE* port, DCB* settings,
+--						LPCSTR* error)
 --					BOOL SetupComm()
+--					void CloseSession(char* readBuffer, BOOL waitingOnRead)
 --
 --	DATE:			October 3, 2015
 --
---	REVISIONS:		N/A
+--	REVISIONS:		October 19, 2026 - reads return as soon as any byte arrives
+--					October 19, 2026 - writes go through a queue of pooled nodes
+--									   drained by a writer thread
+--					October 19, 2026 - write queues and opening a port work on
+--									   any port, for the bridge
+--					October 19, 2026 - each write queue has its own node pool
+--									   and signals when it drains
 --
 --	DESIGNER:		Alvin Man
 --
@@ -37,23 +50,35 @@
 #include <windows.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "header.h"
 
 // function prototype
 BOOL SetupComm();
+void CloseSession(char* readBuffer, BOOL waitingOnRead);
+DWORD WINAPI WriterThread(LPVOID param);
 
 // declared variables
 HANDLE hComm;
 OVERLAPPED o;
 DCB dcb;
 HDC hdc;
+WRITEQUEUE terminalWriter;
 
 /*-----------------------------------------------------------------------------------
 --	FUNCTION: MonitorInputThread
 --
 --	DATE:			October 3, 2015
 --
---	REVISIONS:		N/A
+--	REVISIONS:		October 19, 2026 - hands the port to the analyzer when it
+--									   is turned on
+--					October 19, 2026 - reads into a pooled buffer, runs the
+--									   writer thread, releases everything on
+--									   disconnect
+--					October 19, 2026 - hands reads to FrameInput in framing
+--									   mode
+--					October 19, 2026 - closes the session through CloseSession
+--									   on every exit path
 --
 --	DESIGNER:		Alvin Man
 --
@@ -68,21 +93,41 @@ HDC hdc;
 -----------------------------------------------------------------------------------*/
 DWORD WINAPI MonitorInputThread(LPVOID hwnd) {
 
-	DWORD readBytes;
+	DWORD readBytes = 0;
 	DWORD dwRes;
 	DWORD readThreadExitCode;
-	char readBuffer[80] = "\0\0\0\0\0\0\0\0\0\0";
+	char* readBuffer;
 	BOOL waitingOnRead = FALSE;
 
 	if (!SetupComm()) {
 		OutputDebugString("Error occurred while setting up communications");
+		readThread = 0; // lets Connect start a new read thread
 		return 0;
 	}
 
+	if (!StartWriter(&terminalWriter, hComm)) {
+		OutputDebugString("Error starting writer thread");
+	}
+
+	if (analyzerEnabled) {
+		return AnalyzeInput(); // timestamps bytes instead of printing them
+	}
+	if (framingMode != FRAMING_OFF) {
+		StartFraming();
+	}
+
 	// create manual reset event for asynchronous I/O
 	o.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
 	if (o.hEvent == NULL) {
 		OutputDebugString("Error creating reset event");
+		CloseSession(NULL, FALSE);
+		return 0;
+	}
+
+	readBuffer = (char*)PoolAlloc(&rxPool);
+	if (readBuffer == NULL) {
+		OutputDebugString("Error getting a receive buffer");
+		CloseSession(NULL, FALSE);
 		return 0;
 	}
 
@@ -92,23 +137,18 @@ DWORD WINAPI MonitorInputThread(LPVOID hwnd) {
 		if (!connected) {
 			if (GetExitCodeThread(readThread, &readThreadExitCode) != 0) {
 
-				readThread = 0;
-				if (!CloseHandle(hComm)) {
-					OutputDebugString("Error closing handle");
-				} else {
-					OutputDebugString("thread closed");
-				}
-				
+				CloseSession(readBuffer, waitingOnRead);
 				ExitThread(readThreadExitCode);
 			}
 		}
 
 		if (!waitingOnRead) {
 			//attempt to read the character from the serial port
-			if (!ReadFile(hComm, readBuffer, sizeof(readBuffer), &readBytes, &o)) {
+			if (!ReadFile(hComm, readBuffer, RX_BUFFER_SIZE, &readBytes, &o)) {
 				if (GetLastError() != ERROR_IO_PENDING) {
 					MessageBox(NULL, "Error reading from serial port", "", MB_OK);
-					readThread = 0;
+					connected = FALSE;
+					CloseSession(readBuffer, FALSE);
 					break;
 				} else {
 					waitingOnRead = TRUE;
@@ -121,11 +161,10 @@ DWORD WINAPI MonitorInputThread(LPVOID hwnd) {
 			dwRes = WaitForSingleObject(o.hEvent, READ_TIMEOUT);
 			switch (dwRes) {
 			case WAIT_OBJECT_0:
+				waitingOnRead = FALSE; // completed, even if it failed
 				if (!GetOverlappedResult(hComm, &o, &readBytes, FALSE)) {
 					MessageBox(NULL, "Error reading file", "", MB_OK);
-					break;
 				}
-				waitingOnRead = FALSE;
 				break;
 			case WAIT_TIMEOUT:
 				break;
@@ -134,9 +173,16 @@ DWORD WINAPI MonitorInputThread(LPVOID hwnd) {
 			}
 		}
 
-		// If we have read characters, print them to the screen
+		// If we have read characters, print them to the screen, or the packets
+		// they make up in framing mode
 		if (readBytes) {
-			PrintToScreen(readBuffer);
+			if (framingMode != FRAMING_OFF) {
+				FrameInput(readBuffer, readBytes);
+			} else {
+				PrintToScreen(readBuffer, readBytes);
+			}
+			CheckSteadyState(readBytes);
+			readBytes = 0;
 		}
 	}
 	return 0;
@@ -147,7 +193,9 @@ DWORD WINAPI MonitorInputThread(LPVOID hwnd) {
 --
 --	DATE:			October 3, 2015
 --
---	REVISIONS:		N/A
+--	REVISIONS:		October 19, 2026 - queues the character for the writer
+--									   thread instead of creating an event and
+--									   waiting on every keystroke
 --
 --	DESIGNER:		Alvin Man
 --
@@ -162,49 +210,340 @@ DWORD WINAPI MonitorInputThread(LPVOID hwnd) {
 -----------------------------------------------------------------------------------*/
 void WriteToSerial(WPARAM wParam) {
 
+	char c = (char)wParam;
+
+	if (connected) {  //only write chars if connected state is true
+		if (!QueueWrite(&terminalWriter, &c, 1)) {
+			OutputDebugString("write queue full, data dropped");
+		}
+	}
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: InitWriteQueue
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - takes the pool the nodes come from
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void InitWriteQueue(WRITEQUEUE* queue, POOL* pool)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Prepares a write queue for use, taking its nodes from pool.
+--					Called once per queue, before its writer is first started.
+-----------------------------------------------------------------------------------*/
+void InitWriteQueue(WRITEQUEUE* queue, POOL* pool) {
+	InitializeCriticalSection(&queue->lock);
+	queue->port = INVALID_HANDLE_VALUE;
+	queue->thread = NULL;
+	queue->queued = NULL;
+	queue->drained = NULL;
+	queue->pool = pool;
+	queue->stopping = FALSE;
+	queue->head = NULL;
+	queue->tail = NULL;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: QueueWrite
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - takes the queue to write to
+--					October 19, 2026 - nodes come from the queue's own pool
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		BOOL QueueWrite(WRITEQUEUE* queue, const char* data, DWORD length)
+--
+--	RETURNS:		BOOL - FALSE if the writer is not running or the queue is full
+--
+--	NOTES:			Copies the data into write nodes from the queue's pool and
+--					hands them to the writer thread.  Nothing is queued unless all
+--					of the data fits, so a caller that can wait may retry once the
+--					queue's drained event is signalled.
+-----------------------------------------------------------------------------------*/
+BOOL QueueWrite(WRITEQUEUE* queue, const char* data, DWORD length) {
+	WRITENODE* first = NULL;
+	WRITENODE* last = NULL;
+
+	//copy into nodes before taking the lock
+	while (length > 0) {
+		WRITENODE* node = (WRITENODE*)PoolAlloc(queue->pool);
+		if (node == NULL) {
+			while (first != NULL) {
+				node = first->next;
+				PoolFree(queue->pool, first);
+				first = node;
+			}
+			return false;
+		}
+		node->next = NULL;
+		node->length = min(length, (DWORD)WRITE_NODE_SIZE);
+		memcpy(node->data, data, node->length);
+		data += node->length;
+		length -= node->length;
+
+		if (last == NULL) {
+			first = node;
+		} else {
+			last->next = node;
+		}
+		last = node;
+	}
+
+	EnterCriticalSection(&queue->lock);
+	BOOL running = (queue->thread != NULL && !queue->stopping);
+	if (running && first != NULL) {
+		if (queue->tail == NULL) {
+			queue->head = first;
+		} else {
+			queue->tail->next = first;
+		}
+		queue->tail = last;
+		SetEvent(queue->queued);
+	}
+	LeaveCriticalSection(&queue->lock);
+
+	if (!running) {
+		while (first != NULL) {
+			last = first->next;
+			PoolFree(queue->pool, first);
+			first = last;
+		}
+	}
+	return running;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: StartWriter
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - takes the queue and the port it writes to
+--					October 19, 2026 - creates the drained event
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		BOOL StartWriter(WRITEQUEUE* queue, HANDLE port)
+--
+--	RETURNS:		BOOL - FALSE if the writer thread could not be started
+--
+--	NOTES:			Starts the thread that writes queued nodes to the port.  Called
+--					once the port is open.
+-----------------------------------------------------------------------------------*/
+BOOL StartWriter(WRITEQUEUE* queue, HANDLE port) {
+	HANDLE queued = CreateEvent(NULL, FALSE, FALSE, NULL);
+	HANDLE drained = CreateEvent(NULL, FALSE, FALSE, NULL);
+	if (queued == NULL || drained == NULL) {
+		if (queued != NULL) {
+			CloseHandle(queued);
+		}
+		if (drained != NULL) {
+			CloseHandle(drained);
+		}
+		return false;
+	}
+
+	EnterCriticalSection(&queue->lock);
+	queue->port = port;
+	queue->queued = queued;
+	queue->drained = drained;
+	queue->stopping = FALSE;
+	queue->thread = CreateThread(NULL, 0, WriterThread, queue, 0, NULL);
+	BOOL started = (queue->thread != NULL);
+	if (!started) {
+		queue->queued = NULL;
+		queue->drained = NULL;
+	}
+	LeaveCriticalSection(&queue->lock);
+
+	if (!started) {
+		CloseHandle(queued);
+		CloseHandle(drained);
+	}
+	return started;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: StopWriter
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - takes the queue to stop
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void StopWriter(WRITEQUEUE* queue)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Lets the writer thread finish what is queued and waits for it
+--					to exit.  Called before the port is closed.
+-----------------------------------------------------------------------------------*/
+void StopWriter(WRITEQUEUE* queue) {
+	EnterCriticalSection(&queue->lock);
+	HANDLE thread = queue->thread;
+	queue->stopping = TRUE;
+	if (queue->queued != NULL) {
+		SetEvent(queue->queued);
+	}
+	LeaveCriticalSection(&queue->lock);
+
+	if (thread == NULL) {
+		return;
+	}
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+
+	EnterCriticalSection(&queue->lock);
+	CloseHandle(queue->queued);
+	CloseHandle(queue->drained);
+	queue->thread = NULL;
+	queue->queued = NULL;
+	queue->drained = NULL;
+	LeaveCriticalSection(&queue->lock);
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: WriterThread
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - drains the queue it is passed
+--					October 19, 2026 - signals drained after each batch
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		DWORD WINAPI WriterThread(LPVOID param)
+--
+--	RETURNS:		DWORD
+--
+--	NOTES:			Takes everything off the write queue at once and writes it to
+--					the port node by node, using one overlapped event for the whole
+--					session.  Signals the queue's drained event once a batch has
+--					been written and its nodes returned to the pool.  Exits once
+--					stopped and the queue is empty.
+-----------------------------------------------------------------------------------*/
+DWORD WINAPI WriterThread(LPVOID param) {
+
+	WRITEQUEUE* queue = (WRITEQUEUE*)param;
+	OVERLAPPED ov = { 0 };
 	DWORD dwWritten;
-	DWORD dwRes;
-	BOOL fRes;
+	BOOL stopping = FALSE;
 
 	// create manual reset event for asynchronous I/O
-	o.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
-	if (o.hEvent == NULL) {
-		MessageBox(NULL, "Error creating reset event", "", MB_OK);
+	ov.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+	if (ov.hEvent == NULL) {
+		OutputDebugString("Error creating reset event");
+		return 0;
 	}
 
-	char str[10] = "";
-	sprintf_s(str, "%c", (char)wParam); // Convert char to string
+	while (!stopping) {
+		WaitForSingleObject(queue->queued, INFINITE);
 
-	if (connected) {  //only write chars if connected state is true
-		if (!WriteFile(hComm, str, 1, &dwWritten, &o)) {
-			if (GetLastError() != ERROR_IO_PENDING) {
-				// writing to serial port failed
-				MessageBox(NULL, "Error writing file", "", MB_OK);
-				fRes = FALSE;
-			} else {
-				// write operation is pending
-				dwRes = WaitForSingleObject(o.hEvent, INFINITE);
-				switch (dwRes) {
-					// OVERLAPPED Structure's event signaled
-					case WAIT_OBJECT_0:
-						if (!GetOverlappedResult(hComm, &o, &dwWritten, FALSE)) {
-							fRes = FALSE;
-						} else {
-							//write completed successfully
-							fRes = TRUE;
-						}
-						break;
-					default:
-						//error occurred in WaitForSingleObject
-						fRes = FALSE;
-						break;
+		EnterCriticalSection(&queue->lock);
+		WRITENODE* node = queue->head;
+		queue->head = queue->tail = NULL;
+		stopping = queue->stopping;
+		LeaveCriticalSection(&queue->lock);
+
+		while (node != NULL) {
+			if (!WriteFile(queue->port, node->data, node->length, &dwWritten, &ov)) {
+				if (GetLastError() != ERROR_IO_PENDING
+					|| !GetOverlappedResult(queue->port, &ov, &dwWritten, TRUE)) {
+					// writing to serial port failed
+					OutputDebugString("Error writing file");
 				}
 			}
-		} else {
-			//writefile completed successfully
-			fRes = TRUE;
+
+			WRITENODE* next = node->next;
+			PoolFree(queue->pool, node);
+			node = next;
 		}
+		SetEvent(queue->drained);
+	}
+
+	CloseHandle(ov.hEvent);
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: OpenCommPort
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		BOOL OpenCommPort(LPCSTR name, HANDLE* port, DCB* settings,
+--						LPCSTR* error)
+--
+--	RETURNS:		BOOL - FALSE if the port could not be opened, with error set
+--
+--	NOTES:			Opens a port by name with the asynchronous I/O flag, clears
+--					what it has received and reads back its settings.  Reads on it
+--					return as soon as any character is available instead of waiting
+--					for the whole buffer to fill.  Shared by the terminal and the
+--					bridge.
+-----------------------------------------------------------------------------------*/
+BOOL OpenCommPort(LPCSTR name, HANDLE* port, DCB* settings, LPCSTR* error) {
+
+	char path[MAX_PATH];
+	COMMTIMEOUTS timeouts;
+
+	//the device namespace prefix lets ports above COM9 be opened
+	sprintf_s(path, sizeof(path), "\\\\.\\%s", name);
+	if ((*port = CreateFile(path, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL)) == INVALID_HANDLE_VALUE) {
+		*error = "Error opening COM port:";
+		return false;
+	}
+
+	//clear the read buffer so users do not retrieve chars when they press connect
+	if (!PurgeComm(*port, PURGE_RXABORT)) {
+		OutputDebugString("error purging");
+	}
+
+	if (!GetCommState(*port, settings)) {
+		//error getting DC settings
+		*error = "Error initializing DCB";
+		CloseHandle(*port);
+		return false;
+	}
+
+	if (!SetCommState(*port, settings)) {
+		//error setting commstate
+		*error = "Error setting DCB";
+		CloseHandle(*port);
+		return false;
 	}
+
+	timeouts.ReadIntervalTimeout = MAXDWORD;
+	timeouts.ReadTotalTimeoutMultiplier = MAXDWORD;
+	timeouts.ReadTotalTimeoutConstant = READ_TIMEOUT;
+	timeouts.WriteTotalTimeoutMultiplier = 0;
+	timeouts.WriteTotalTimeoutConstant = 0;
+	if (!SetCommTimeouts(*port, &timeouts)) {
+		OutputDebugString("error setting timeouts");
+	}
+
+	return true;
 }
 
 /*-----------------------------------------------------------------------------------
@@ -212,7 +551,10 @@ void WriteToSerial(WPARAM wParam) {
 --
 --	DATE:			October 3, 2015
 --
---	REVISIONS:		N/A
+--	REVISIONS:		October 19, 2026 - sets read timeouts so echoed characters
+--									   are delivered as soon as they arrive
+--					October 19, 2026 - opens the port through OpenCommPort
+--					October 19, 2026 - applies an auto-detected baud rate
 --
 --	DESIGNER:		Alvin Man
 --
@@ -227,30 +569,69 @@ void WriteToSerial(WPARAM wParam) {
 -----------------------------------------------------------------------------------*/
 BOOL SetupComm() {
 
-	if ((hComm = CreateFile(lpszCommName, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL)) == INVALID_HANDLE_VALUE) {
-		MessageBox(NULL, "Error opening COM port:", "", MB_OK);
+	LPCSTR error;
+
+	if (!OpenCommPort(lpszCommName, &hComm, &dcb, &error)) {
+		MessageBox(NULL, error, "", MB_OK);
 		connected = FALSE;
 		return false;
 	}
 
-	//clear the read buffer so users do not retrieve chars when they press connect
-	if (hComm) {
-		if (!PurgeComm(hComm, PURGE_RXABORT)) {
-			OutputDebugString("error purging");
+	//use the rate the port answered at when it was probed
+	if (detectedBaud != 0 && detectedBaud != dcb.BaudRate) {
+		dcb.BaudRate = detectedBaud;
+		if (!SetCommState(hComm, &dcb)) {
+			OutputDebugString("error setting detected baud rate");
 		}
 	}
 
-	if (!GetCommState(hComm, &dcb)) {
-		//error getting DC settings
-		MessageBox(NULL, "Error initializing DCB", "", MB_OK);
-		return false;
-	}
+	return true;
+}
 
-	if (!SetCommState(hComm, &dcb)) {
-		//error setting commstate
-		MessageBox(NULL, "Error setting DCB", "", MB_OK);
-		return false;
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: CloseSession
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - lets Connect start a new read thread only
+--									   once the port is closed
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void CloseSession(char* readBuffer, BOOL waitingOnRead)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Called by the read thread on its way out once the port is open.
+--					A read still pending is cancelled and waited for before its
+--					buffer goes back to the pool, since a late byte would land on
+--					the pool's free list link.  Then stops the writer and closes
+--					the port.  readThread is cleared last: a new read thread
+--					started any earlier could not open the port, would overwrite
+--					hComm and would race this one on terminalWriter.
+-----------------------------------------------------------------------------------*/
+void CloseSession(char* readBuffer, BOOL waitingOnRead) {
+	DWORD unused;
+
+	if (waitingOnRead) {
+		CancelIo(hComm);
+		GetOverlappedResult(hComm, &o, &unused, TRUE);
 	}
 
-	return true;
-}
\ No newline at end of file
+	StopWriter(&terminalWriter);
+	if (readBuffer != NULL) {
+		PoolFree(&rxPool, readBuffer);
+	}
+	if (o.hEvent != NULL) {
+		CloseHandle(o.hEvent);
+		o.hEvent = NULL;
+	}
+	if (!CloseHandle(hComm)) {
+		OutputDebugString("Error closing handle");
+	} else {
+		OutputDebugString("thread closed");
+	}
+	readThread = 0; // lets Connect start a new read thread
+}
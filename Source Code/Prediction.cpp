@@ -0,0 +1,410 @@
+/*-----------------------------------------------------------------------------------
+--	SOURCE FILE:	Prediction.cpp - Predictive local echo for the terminal emulator,
+--									 drawing typed characters before the device
+--									 echoes them back over a slow link.
+--
+--	PROGRAM:        Terminal Emulator
+--
+--	FUNCTIONS:
+--					void SetPrediction(BOOL enable)
+--					void PredictKeystroke(char c)
+--					void ConfirmPrediction(char c)
+--					void RevealPredictions()
+--					void ExpirePredictions()
+--					int GetPredictionCount()
+--					const PREDICTION* GetPrediction(int i)
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	NOTES:			Prediction.cpp is part of a minimal Windows terminal emulator,
+--					that transmits characters typed on the keyboard to the serial
+--					port and displays all characters received via the serial port.
+--
+--					Printable keystrokes are queued as predictions and drawn
+--					underlined at the cursor as soon as they are typed.  Each
+--					received character is compared against the oldest prediction:
+--					a match confirms it, anything else rolls all of them back.
+--
+--					Predictions are grouped into epochs.  Any keystroke that cannot
+--					be predicted (Enter, Backspace, control keys) or a rollback
+--					starts a new epoch, whose predictions stay hidden until the
+--					device echoes the first of them.  This keeps command output and
+--					screens that do not echo from being scribbled over.
+--
+--					Prediction is suspended while a password prompt is on screen,
+--					and switches itself off after PREDICT_MISS_LIMIT mispredictions.
+--
+--					All functions expect the caller to hold screenLock, except for
+--					the ones called directly from WndProc.
+-----------------------------------------------------------------------------------*/
+
+#define STRICT
+
+#include <windows.h>
+#include <ctype.h>
+#include "header.h"
+
+// declared variables
+BOOL predictEnabled = FALSE;
+static PREDICTION predictions[PREDICT_MAX]; // ring of keystrokes awaiting their echo
+static int predictHead = 0;                 // oldest prediction
+static int predictCount = 0;
+static DWORD currentEpoch = 1;              // epoch new keystrokes are added to
+static DWORD confirmedEpoch = 0;            // latest epoch the device has echoed
+static BOOL passwordPrompt = FALSE;         // device is asking for a secret
+static int mispredictions = 0;
+static const char* promptWords[] = { "password", "passphrase" };
+static int promptMatch[2] = { 0, 0 };       // progress into each prompt word
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: PredictionAt
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static PREDICTION* PredictionAt(int i)
+--
+--	RETURNS:		PREDICTION* - the i-th oldest pending prediction
+--
+--	NOTES:			Maps a queue position onto the prediction ring.
+-----------------------------------------------------------------------------------*/
+static PREDICTION* PredictionAt(int i) {
+	return &predictions[(predictHead + i) % PREDICT_MAX];
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: LastShownPrediction
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static const PREDICTION* LastShownPrediction()
+--
+--	RETURNS:		const PREDICTION* - newest prediction on screen, or NULL
+--
+--	NOTES:			The next tentative character is drawn right after this one.
+-----------------------------------------------------------------------------------*/
+static const PREDICTION* LastShownPrediction() {
+	for (int i = predictCount - 1; i >= 0; i--) {
+		if (PredictionAt(i)->shown) {
+			return PredictionAt(i);
+		}
+	}
+	return NULL;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: RollbackPredictions
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static void RollbackPredictions(BOOL mispredicted)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Erases every tentative character and empties the queue.  When
+--					the rollback was caused by a wrong guess that was on screen, it
+--					counts towards PREDICT_MISS_LIMIT.
+-----------------------------------------------------------------------------------*/
+static void RollbackPredictions(BOOL mispredicted) {
+	BOOL anyShown = FALSE;
+
+	for (int i = 0; i < predictCount; i++) {
+		if (PredictionAt(i)->shown) {
+			ErasePrediction(PredictionAt(i));
+			anyShown = TRUE;
+		}
+	}
+	predictHead = 0;
+	predictCount = 0;
+	currentEpoch++;
+
+	if (mispredicted && anyShown && ++mispredictions >= PREDICT_MISS_LIMIT) {
+		//the device is not echoing what we type, stop guessing
+		predictEnabled = FALSE;
+		OutputDebugString("too many mispredictions, predictive echo off");
+		PostMessage(hwnd, WM_PREDICT_OFF, 0, 0);
+	}
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: MatchPasswordPrompt
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static BOOL MatchPasswordPrompt(char c)
+--
+--	RETURNS:		BOOL - TRUE when c completes a password prompt keyword
+--
+--	NOTES:			Scans the received stream one character at a time for the
+--					words in promptWords, ignoring case.
+-----------------------------------------------------------------------------------*/
+static BOOL MatchPasswordPrompt(char c) {
+	BOOL found = FALSE;
+	char lower = (char)tolower((unsigned char)c);
+
+	for (int i = 0; i < 2; i++) {
+		if (promptWords[i][promptMatch[i]] != lower) {
+			promptMatch[i] = 0;
+		}
+		if (promptWords[i][promptMatch[i]] == lower) {
+			promptMatch[i]++;
+		}
+		if (promptWords[i][promptMatch[i]] == '\0') {
+			promptMatch[i] = 0;
+			found = TRUE;
+		}
+	}
+	return found;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: SetPrediction
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void SetPrediction(BOOL enable)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Turns predictive echo on or off and starts it over with a clean
+--					misprediction count.
+-----------------------------------------------------------------------------------*/
+void SetPrediction(BOOL enable) {
+	EnterCriticalSection(&screenLock);
+	RollbackPredictions(FALSE);
+	predictEnabled = enable;
+	passwordPrompt = FALSE;
+	mispredictions = 0;
+	LeaveCriticalSection(&screenLock);
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: PredictKeystroke
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void PredictKeystroke(char c)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Called for every keystroke before it is written to the port.
+--					Printable characters are queued and, if their epoch has been
+--					confirmed, drawn immediately.  Anything else starts a new epoch.
+-----------------------------------------------------------------------------------*/
+void PredictKeystroke(char c) {
+	PREDICTION* p;
+
+	if (!predictEnabled || !connected) {
+		return;
+	}
+
+	EnterCriticalSection(&screenLock);
+	if (c >= ' ' && c <= '~') {
+		if (!passwordPrompt && predictCount < PREDICT_MAX) {
+			const PREDICTION* last = LastShownPrediction();
+			p = PredictionAt(predictCount++);
+			p->ch = c;
+			p->epoch = currentEpoch;
+			p->sentTime = GetTickCount();
+			p->shown = (currentEpoch == confirmedEpoch);
+			if (p->shown) {
+				DrawPrediction(p, last);
+			}
+		}
+	} else {
+		if (c == '\r' || c == '\n') {
+			//the secret has been entered
+			passwordPrompt = FALSE;
+		}
+		currentEpoch++;
+	}
+	LeaveCriticalSection(&screenLock);
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: ConfirmPrediction
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void ConfirmPrediction(char c)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Called for every received character before it is printed.  A
+--					character matching the oldest prediction confirms it and its
+--					epoch, any other character rolls the predictions back.
+-----------------------------------------------------------------------------------*/
+void ConfirmPrediction(char c) {
+	PREDICTION* p;
+
+	if (MatchPasswordPrompt(c)) {
+		passwordPrompt = TRUE;
+		RollbackPredictions(FALSE);
+		return;
+	}
+
+	if (predictCount == 0) {
+		return;
+	}
+
+	p = PredictionAt(0);
+	if (p->ch != c) {
+		RollbackPredictions(TRUE);
+		return;
+	}
+
+	if (p->epoch > confirmedEpoch) {
+		confirmedEpoch = p->epoch;
+	}
+	predictHead = (predictHead + 1) % PREDICT_MAX;
+	predictCount--;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: RevealPredictions
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void RevealPredictions()
+--
+--	RETURNS:		void
+--
+--	NOTES:			Called after a received character has been printed.  Draws the
+--					hidden predictions of an epoch that has just been confirmed.
+-----------------------------------------------------------------------------------*/
+void RevealPredictions() {
+	const PREDICTION* last = NULL;
+
+	for (int i = 0; i < predictCount; i++) {
+		PREDICTION* p = PredictionAt(i);
+		if (!p->shown && p->epoch == confirmedEpoch) {
+			DrawPrediction(p, last);
+			p->shown = TRUE;
+		}
+		if (p->shown) {
+			last = p;
+		}
+	}
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: ExpirePredictions
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void ExpirePredictions()
+--
+--	RETURNS:		void
+--
+--	NOTES:			Called from the prediction timer.  If the device has not echoed
+--					the oldest keystroke within PREDICT_TIMEOUT, echo is most likely
+--					off and the predictions are rolled back.
+-----------------------------------------------------------------------------------*/
+void ExpirePredictions() {
+	EnterCriticalSection(&screenLock);
+	if (predictCount > 0 && GetTickCount() - PredictionAt(0)->sentTime > PREDICT_TIMEOUT) {
+		RollbackPredictions(TRUE);
+	}
+	LeaveCriticalSection(&screenLock);
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: GetPredictionCount
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		int GetPredictionCount()
+--
+--	RETURNS:		int - number of keystrokes awaiting their echo
+--
+--	NOTES:			Lets the screen paint the tentative characters.
+-----------------------------------------------------------------------------------*/
+int GetPredictionCount() {
+	return predictCount;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: GetPrediction
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		const PREDICTION* GetPrediction(int i)
+--
+--	RETURNS:		const PREDICTION* - the i-th oldest keystroke awaiting its echo
+--
+--	NOTES:			Lets the screen paint the tentative characters.
+-----------------------------------------------------------------------------------*/
+const PREDICTION* GetPrediction(int i) {
+	return PredictionAt(i);
+}
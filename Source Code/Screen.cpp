@@ -0,0 +1,687 @@
+/*-----------------------------------------------------------------------------------
+--	SOURCE FILE:	Screen.cpp - Screen and scrollback of the terminal emulator,
+--								 holding received text as logical lines and
+--								 painting them onto a character cell grid.
+--
+--	PROGRAM:        Terminal Emulator
+--
+--	FUNCTIONS:
+--					void InitScreen()
+--					void ScreenPutChar(char c)
+--					void ResizeScreen(int width, int height)
+--					void ScrollScreen(int rows)
+--					void ScrollScreenTo(int line)
+--					void UpdateScrollBar()
+--					void PaintScreen(HDC hdcPaint)
+--					void DrawPrediction(PREDICTION* p, const PREDICTION* last)
+--					void ErasePrediction(const PREDICTION* p)
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - scroll bar set where the view changes
+--									   instead of while painting
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	NOTES:			Screen.cpp is part of a minimal Windows terminal emulator,
+--					that transmits characters typed on the keyboard to the serial
+--					port and displays all characters received via the serial port.
+--
+--					Received text is kept as logical lines, ended only by a line
+--					feed, in two rings: one of characters and one of line records.
+--					When either ring fills up the oldest line is dropped.
+--
+--					Lines are soft-wrapped to the width of the window when they
+--					are painted, never when they are stored.  A line's row count is
+--					worked out from its length on demand, so resizing the window
+--					only rewraps the rows that are about to be painted, and history
+--					is rewrapped as it is scrolled into view.  The scroll position
+--					is kept as a logical line and a row within it, so it survives a
+--					resize without having to count the rows above it.
+--
+--					All functions expect the caller to hold screenLock, except for
+--					the ones called directly from WndProc.
+-----------------------------------------------------------------------------------*/
+
+#define STRICT
+
+#include <windows.h>
+#include <stdlib.h>
+#include "header.h"
+
+#define HISTORY_CHARS   0x800000   // characters of scrollback, power of two
+#define HISTORY_LINES   0x20000    // logical lines of scrollback, power of two
+#define MAX_LINE_LENGTH 4096       // longest logical line before a hard break
+#define MAX_COLUMNS     512        // widest row that is painted
+#define TAB_WIDTH       8
+
+// A logical line in the scrollback
+typedef struct {
+	DWORD start;      // offset of its first character in historyText
+	DWORD length;
+} LINE;
+
+// A row on screen, as a logical line and a soft-wrapped row within it
+typedef struct {
+	DWORD line;
+	int row;
+} VIEWPOS;
+
+// declared variables
+HFONT screenFont;             // fixed pitch font for received characters
+HFONT predictFont;            // underlined font for tentative characters
+static char* historyText;     // ring of received characters
+static LINE* historyLines;    // ring of logical lines
+static DWORD firstLine = 0;   // oldest line still held
+static DWORD lastLine = 0;    // line being written to
+static int cursorColumn = 0;  // column of the cursor within lastLine
+static int cellWidth = 8, cellHeight = 16;
+static int screenColumns = 1, screenRows = 1;
+static int clientWidth = 0, clientHeight = 0;
+static BOOL followOutput = TRUE; // view stays on the newest line
+static VIEWPOS viewTop = { 0, 0 }; // top row of the view when not following
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: LineAt
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static LINE* LineAt(DWORD line)
+--
+--	RETURNS:		LINE* - record of the given logical line
+--
+--	NOTES:			Maps a line number onto the line ring.
+-----------------------------------------------------------------------------------*/
+static LINE* LineAt(DWORD line) {
+	return &historyLines[line & (HISTORY_LINES - 1)];
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: LineRows
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static int LineRows(DWORD line)
+--
+--	RETURNS:		int - number of rows the line wraps onto at the current width
+--
+--	NOTES:			The line being written to also covers the cursor and any
+--					tentative characters past its end.
+-----------------------------------------------------------------------------------*/
+static int LineRows(DWORD line) {
+	int extent = LineAt(line)->length;
+
+	if (line == lastLine) {
+		if (extent < cursorColumn + 1) {
+			extent = cursorColumn + 1;
+		}
+		for (int i = 0; i < GetPredictionCount(); i++) {
+			const PREDICTION* p = GetPrediction(i);
+			if (p->shown && extent < p->column + 1) {
+				extent = p->column + 1;
+			}
+		}
+	}
+	return extent == 0 ? 1 : (extent + screenColumns - 1) / screenColumns;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: IsBefore
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static BOOL IsBefore(VIEWPOS a, VIEWPOS b)
+--
+--	RETURNS:		BOOL - TRUE if row a is above row b
+--
+--	NOTES:			Orders two rows of the scrollback.
+-----------------------------------------------------------------------------------*/
+static BOOL IsBefore(VIEWPOS a, VIEWPOS b) {
+	return (a.line - firstLine) < (b.line - firstLine) || (a.line == b.line && a.row < b.row);
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: BottomViewTop
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static VIEWPOS BottomViewTop()
+--
+--	RETURNS:		VIEWPOS - top row of a view that ends on the newest line
+--
+--	NOTES:			Walks back from the newest line until the screen is filled, so
+--					only the visible lines are wrapped.
+-----------------------------------------------------------------------------------*/
+static VIEWPOS BottomViewTop() {
+	VIEWPOS top;
+	int needed = screenRows;
+
+	top.line = lastLine;
+	while (1) {
+		int rows = LineRows(top.line);
+		if (rows >= needed) {
+			top.row = rows - needed;
+			return top;
+		}
+		needed -= rows;
+		if (top.line == firstLine) {
+			top.row = 0;
+			return top;
+		}
+		top.line--;
+	}
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: ViewTop
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static VIEWPOS ViewTop()
+--
+--	RETURNS:		VIEWPOS - top row of the view
+--
+--	NOTES:			Keeps a scrolled back view inside the scrollback, in case the
+--					lines it was showing have since been dropped or rewrapped.
+-----------------------------------------------------------------------------------*/
+static VIEWPOS ViewTop() {
+	VIEWPOS bottom = BottomViewTop();
+
+	if (followOutput) {
+		return bottom;
+	}
+	if (viewTop.line - firstLine > lastLine - firstLine) {
+		//the line at the top of the view has been dropped
+		viewTop.line = firstLine;
+		viewTop.row = 0;
+	}
+	if (viewTop.row >= LineRows(viewTop.line)) {
+		viewTop.row = LineRows(viewTop.line) - 1;
+	}
+	if (!IsBefore(viewTop, bottom)) {
+		followOutput = TRUE;
+		return bottom;
+	}
+	return viewTop;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: DropOldestLine
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static void DropOldestLine()
+--
+--	RETURNS:		void
+--
+--	NOTES:			Frees the oldest line of the scrollback to make room.
+-----------------------------------------------------------------------------------*/
+static void DropOldestLine() {
+	if (firstLine != lastLine) {
+		firstLine++;
+	}
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: NewLine
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		static void NewLine()
+--
+--	RETURNS:		void
+--
+--	NOTES:			Ends the line being written to and starts an empty one.
+-----------------------------------------------------------------------------------*/
+static void NewLine() {
+	LINE* current = LineAt(lastLine);
+	DWORD start = current->start + current->length;
+
+	if (lastLine - firstLine + 1 >= HISTORY_LINES) {
+		DropOldestLine();
+	}
+	lastLine++;
+	LineAt(lastLine)->start = start;
+	LineAt(lastLine)->length = 0;
+	cursorColumn = 0;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: InitScreen
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - scrollback comes from the session arena
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void InitScreen()
+--
+--	RETURNS:		void
+--
+--	NOTES:			Carves the scrollback out of the session arena and creates the
+--					fonts.  The character cell is taken from the metrics of the
+--					fixed pitch font.
+-----------------------------------------------------------------------------------*/
+void InitScreen() {
+	LOGFONT lf;
+	TEXTMETRIC tm;
+
+	historyText = (char*)ArenaAlloc(&sessionArena, HISTORY_CHARS);
+	historyLines = (LINE*)ArenaAlloc(&sessionArena, HISTORY_LINES * sizeof(LINE));
+	if (historyText == NULL || historyLines == NULL) {
+		MessageBox(NULL, "Error allocating scrollback", "", MB_OK);
+		ExitProcess(1);
+	}
+	LineAt(lastLine)->start = 0;
+	LineAt(lastLine)->length = 0;
+
+	// Tentative characters are drawn in an underlined copy of the screen font
+	GetObject(GetStockObject(SYSTEM_FIXED_FONT), sizeof(LOGFONT), &lf);
+	screenFont = CreateFontIndirect(&lf);
+	lf.lfUnderline = TRUE;
+	predictFont = CreateFontIndirect(&lf);
+
+	HDC hdcScreen = GetDC(NULL);
+	HGDIOBJ oldFont = SelectObject(hdcScreen, screenFont);
+	GetTextMetrics(hdcScreen, &tm);
+	SelectObject(hdcScreen, oldFont);
+	ReleaseDC(NULL, hdcScreen);
+
+	cellWidth = tm.tmAveCharWidth;
+	cellHeight = tm.tmHeight + tm.tmExternalLeading;
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: ScreenPutChar
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void ScreenPutChar(char c)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Writes a received character at the cursor.  Carriage return,
+--					line feed, backspace and tab move the cursor, other control
+--					characters are dropped.  A character written before the end of
+--					the line overwrites what is there.
+-----------------------------------------------------------------------------------*/
+void ScreenPutChar(char c) {
+	LINE* current = LineAt(lastLine);
+
+	switch (c) {
+	case '\r':
+		cursorColumn = 0;
+		return;
+	case '\n':
+		NewLine();
+		return;
+	case '\b':
+		if (cursorColumn > 0) {
+			cursorColumn--;
+		}
+		return;
+	case '\t':
+		do {
+			ScreenPutChar(' ');
+		} while (cursorColumn % TAB_WIDTH != 0);
+		return;
+	default:
+		if ((unsigned char)c < ' ' || c == 0x7f) {
+			return;
+		}
+		break;
+	}
+
+	if ((DWORD)cursorColumn >= current->length) {
+		//the line grows, make room for it in the ring
+		while (current->start + current->length + 1 - LineAt(firstLine)->start > HISTORY_CHARS
+			&& firstLine != lastLine) {
+			DropOldestLine();
+		}
+		current->length = cursorColumn + 1;
+	}
+	historyText[(current->start + cursorColumn) & (HISTORY_CHARS - 1)] = c;
+
+	if (++cursorColumn >= MAX_LINE_LENGTH) {
+		NewLine();
+	}
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: ResizeScreen
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - updates the scroll bar
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void ResizeScreen(int width, int height)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Fits the cell grid to a new client area.  Nothing is rewrapped
+--					here, a scrolled back view just keeps the same character at its
+--					top left corner.
+-----------------------------------------------------------------------------------*/
+void ResizeScreen(int width, int height) {
+	EnterCriticalSection(&screenLock);
+	int oldColumns = screenColumns;
+
+	clientWidth = width;
+	clientHeight = height;
+	screenColumns = max(1, min(MAX_COLUMNS, width / cellWidth));
+	screenRows = max(1, height / cellHeight);
+
+	viewTop.row = viewTop.row * oldColumns / screenColumns;
+	LeaveCriticalSection(&screenLock);
+
+	UpdateScrollBar();
+	InvalidateRect(hwnd, NULL, FALSE);
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: ScrollScreen
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - updates the scroll bar
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void ScrollScreen(int rows)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Moves the view by a number of rows, negative to go back into
+--					the scrollback.  Scrolling to the bottom follows new output
+--					again.
+-----------------------------------------------------------------------------------*/
+void ScrollScreen(int rows) {
+	EnterCriticalSection(&screenLock);
+	VIEWPOS bottom = BottomViewTop();
+	VIEWPOS top = ViewTop();
+
+	while (rows < 0 && (top.line != firstLine || top.row > 0)) {
+		if (top.row > 0) {
+			top.row--;
+		} else {
+			top.line--;
+			top.row = LineRows(top.line) - 1;
+		}
+		rows++;
+	}
+	while (rows > 0 && IsBefore(top, bottom)) {
+		if (top.row + 1 < LineRows(top.line)) {
+			top.row++;
+		} else {
+			top.line++;
+			top.row = 0;
+		}
+		rows--;
+	}
+
+	viewTop = top;
+	followOutput = !IsBefore(top, bottom);
+	LeaveCriticalSection(&screenLock);
+
+	UpdateScrollBar();
+	InvalidateRect(hwnd, NULL, FALSE);
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: ScrollScreenTo
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - updates the scroll bar
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void ScrollScreenTo(int line)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Puts a line of the scrollback, counted from the oldest one, at
+--					the top of the view.  Used when the scroll bar is dragged.
+-----------------------------------------------------------------------------------*/
+void ScrollScreenTo(int line) {
+	EnterCriticalSection(&screenLock);
+	viewTop.line = firstLine + min((DWORD)max(line, 0), lastLine - firstLine);
+	viewTop.row = 0;
+	followOutput = FALSE;
+	ViewTop();
+	LeaveCriticalSection(&screenLock);
+
+	UpdateScrollBar();
+	InvalidateRect(hwnd, NULL, FALSE);
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: UpdateScrollBar
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - called on the window thread when the
+--									   view or the scrollback changes, never
+--									   while painting
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void UpdateScrollBar()
+--
+--	RETURNS:		void
+--
+--	NOTES:			The scroll bar counts logical lines rather than rows, so it can
+--					be set without wrapping the whole scrollback.  It is disabled
+--					rather than hidden while there is no history, so setting it
+--					never changes the size of the client area.  Must be called
+--					without holding screenLock.
+-----------------------------------------------------------------------------------*/
+void UpdateScrollBar() {
+	SCROLLINFO si;
+
+	si.cbSize = sizeof(SCROLLINFO);
+	si.fMask = SIF_RANGE | SIF_PAGE | SIF_POS | SIF_DISABLENOSCROLL;
+	si.nMin = 0;
+
+	EnterCriticalSection(&screenLock);
+	si.nMax = (int)(lastLine - firstLine) + screenRows - 1;
+	si.nPage = screenRows;
+	si.nPos = (int)(ViewTop().line - firstLine);
+	LeaveCriticalSection(&screenLock);
+
+	SetScrollInfo(hwnd, SB_VERT, &si, TRUE);
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: PaintScreen
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		October 19, 2026 - no longer sets the scroll bar
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void PaintScreen(HDC hdcPaint)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Paints every row of the view, wrapping lines as it reaches
+--					them, then draws the tentative characters over the line being
+--					written to.
+-----------------------------------------------------------------------------------*/
+void PaintScreen(HDC hdcPaint) {
+	char rowText[MAX_COLUMNS];
+	RECT rowRect;
+
+	EnterCriticalSection(&screenLock);
+	VIEWPOS pos = ViewTop();
+	BOOL pastEnd = FALSE;
+
+	HGDIOBJ oldFont = SelectObject(hdcPaint, screenFont);
+	SetBkMode(hdcPaint, OPAQUE);
+	SetBkColor(hdcPaint, backgroundColor);
+	SetTextColor(hdcPaint, textColor);
+
+	for (int y = 0; y < screenRows; y++) {
+		int count = 0;
+
+		if (!pastEnd) {
+			//copy this row's slice of the line out of the ring
+			LINE* line = LineAt(pos.line);
+			DWORD first = pos.row * screenColumns;
+			for (DWORD i = first; i < line->length && count < screenColumns; i++) {
+				rowText[count++] = historyText[(line->start + i) & (HISTORY_CHARS - 1)];
+			}
+		}
+
+		rowRect.left = 0;
+		rowRect.top = y * cellHeight;
+		rowRect.right = clientWidth;
+		rowRect.bottom = rowRect.top + cellHeight;
+		ExtTextOut(hdcPaint, 0, rowRect.top, ETO_OPAQUE, &rowRect, rowText, count, NULL);
+
+		if (!pastEnd && pos.line == lastLine) {
+			//tentative characters that land on this row
+			SelectObject(hdcPaint, predictFont);
+			for (int i = 0; i < GetPredictionCount(); i++) {
+				const PREDICTION* p = GetPrediction(i);
+				if (p->shown && p->column / screenColumns == pos.row) {
+					TextOut(hdcPaint, (p->column % screenColumns) * cellWidth, rowRect.top, &p->ch, 1);
+				}
+			}
+			SelectObject(hdcPaint, screenFont);
+		}
+
+		if (!pastEnd && ++pos.row >= LineRows(pos.line)) {
+			if (pos.line == lastLine) {
+				pastEnd = TRUE;
+			} else {
+				pos.line++;
+				pos.row = 0;
+			}
+		}
+	}
+
+	//clear the strip below the last whole row
+	rowRect.left = 0;
+	rowRect.top = screenRows * cellHeight;
+	rowRect.right = clientWidth;
+	rowRect.bottom = clientHeight;
+	if (rowRect.top < rowRect.bottom) {
+		ExtTextOut(hdcPaint, 0, rowRect.top, ETO_OPAQUE, &rowRect, "", 0, NULL);
+	}
+
+	SelectObject(hdcPaint, oldFont);
+	LeaveCriticalSection(&screenLock);
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: DrawPrediction
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void DrawPrediction(PREDICTION* p, const PREDICTION* last)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Places a predicted character right after the last prediction on
+--					screen, or at the cursor if there is none.  It is drawn with the
+--					next paint.
+-----------------------------------------------------------------------------------*/
+void DrawPrediction(PREDICTION* p, const PREDICTION* last) {
+	p->column = (last != NULL) ? last->column + 1 : cursorColumn;
+	InvalidateRect(hwnd, NULL, FALSE);
+}
+
+/*-----------------------------------------------------------------------------------
+--	FUNCTION: ErasePrediction
+--
+--	DATE:			October 19, 2026
+--
+--	REVISIONS:		N/A
+--
+--	DESIGNER:		Alvin Man
+--
+--	PROGRAMMER:		Alvin Man
+--
+--	INTERFACE:		void ErasePrediction(const PREDICTION* p)
+--
+--	RETURNS:		void
+--
+--	NOTES:			Clears a tentative character off the screen when it is rolled
+--					back.
+-----------------------------------------------------------------------------------*/
+void ErasePrediction(const PREDICTION* p) {
+	InvalidateRect(hwnd, NULL, FALSE);
+}
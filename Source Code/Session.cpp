@@ -47,7 +47,8 @@ LPCSTR lpszCommName = "COM1";  //default port set to COM1
 --
 --	DATE:			October 3, 2015
 --					
---	REVISIONS:		N/A
+--	REVISIONS:		October 19, 2026 - resets predictive echo
+--					October 19, 2026 - refuses a port that is still being probed
 --
 --	DESIGNER:		Alvin Man
 --
@@ -63,6 +64,11 @@ LPCSTR lpszCommName = "COM1";  //default port set to COM1
 -----------------------------------------------------------------------------------*/
 void Connect() {
 
+	//a port still being probed cannot be opened yet
+	if (!CheckPortIdle(lpszCommName)) {
+		return;
+	}
+
 	//clear the readbuffer first to remove stray characters
 	if (hComm) {
 		if (!PurgeComm(hComm, PURGE_RXABORT)) {
@@ -71,6 +77,7 @@ void Connect() {
 	}
 
 	connected = TRUE;
+	SetPrediction(predictEnabled); // new session, start predicting from scratch
 	//check if readThread has already been created
 	if (readThread == 0) { //create new thread 
 		readThread = CreateThread(NULL, 0, MonitorInputThread, hwnd, 0, NULL);
@@ -116,7 +123,8 @@ void Disconnect() {
 --
 --	DATE:			October 3, 2015
 --
---	REVISIONS:		N/A
+--	REVISIONS:		October 19, 2026 - settings chosen here win over an
+--									   auto-detected baud rate
 --
 --	DESIGNER:		Alvin Man
 --
@@ -142,6 +150,7 @@ BOOL GetCommParameters() {
 		dcb.StopBits = cc.dcb.StopBits;
 		dcb.fRtsControl = cc.dcb.fRtsControl;
 		dcb.fOutxCtsFlow = cc.dcb.fOutxCtsFlow;
+		detectedBaud = 0;
 	}
 
 	// change sizeof(COMMCONFIG) to cc.dwSize
@@ -7,7 +7,15 @@
 --
 --	DATE:			October 3, 2015
 --
---	REVISIONS:		N/A
+--	REVISIONS:		October 19, 2026 - added predictive local echo
+--					October 19, 2026 - added the scrollback screen
+--					October 19, 2026 - added the protocol analyzer
+--					October 19, 2026 - added the session arena, pools and the
+--									   write queue
+--					October 19, 2026 - added the serial to TCP bridge
+--					October 19, 2026 - replaced the fixed COM1 - COM5 items with
+--									   discovered ports
+--					October 19, 2026 - added COBS and SLIP framing
 --
 --	DESIGNER:		Alvin Man
 --
@@ -31,15 +39,93 @@
 #define IDM_Exit		102
 #define IDM_HELP        103
 #define IDM_ConnParams  104
-#define IDM_COM1        105
-#define IDM_COM2        106
-#define IDM_COM3        107
-#define IDM_COM4        108
-#define IDM_COM5        109
 #define IDM_File        110
 #define IDM_Ports       111
+#define IDM_Predict     112
+#define IDM_Analyzer    113
+#define IDM_Histogram   114
+#define IDM_RefreshPorts 115
+#define IDM_AutoBaud    116
+#define IDM_FrameCOBS   117
+#define IDM_FrameSLIP   118
+#define IDM_PORT_BASE   200               // first discovered port, up to MAX_PORTS
+
+#define PORT_MENU       1                 // position of the Port menu in the menu bar
+#define MAX_PORTS       128               // ports listed in the Port menu
+
+#define IDT_PREDICT     1                 // prediction expiry timer
+#define IDT_DISCOVERY   2                 // port probe timeout
+#define IDT_REFRESH     3                 // ports changed, waiting for them to settle
+#define WM_PREDICT_OFF  (WM_APP + 1)      // prediction switched itself off
+#define WM_PORT_PROBED  (WM_APP + 2)      // a port probe finished, lParam is the probe
+#define WM_SCREEN_CHANGED (WM_APP + 3)    // text was added, the scroll bar needs updating
+#define WM_TIMELINE     (WM_APP + 4)      // the analyzer has queued timeline entries
+
+#define BRIDGE_SWITCH     "/bridge"  // command line switch for headless mode
 
 #define READ_TIMEOUT      500      // milliseconds
+#define PREDICT_MAX       256      // keystrokes awaiting their echo
+#define PREDICT_TIMEOUT   2000     // milliseconds before an unechoed char is rolled back
+#define PREDICT_INTERVAL  250      // milliseconds between expiry checks
+#define PREDICT_MISS_LIMIT 5       // mispredictions before prediction turns itself off
+#define SCROLL_PAGE       20       // rows moved by Page Up / Page Down
+#define SCROLL_WHEEL      3        // rows moved per mouse wheel notch
+#define SESSION_ARENA_SIZE 0x1000000 // bytes reserved for session data at startup
+#define RX_BUFFER_SIZE    4096     // bytes in a receive buffer
+#define RX_BUFFERS        16       // receive buffers in rxPool
+#define WRITE_NODE_SIZE   240      // bytes carried by a write queue node
+#define WRITE_NODES       1024     // nodes in writePool
+#define DISCOVERY_TIMEOUT 3000     // milliseconds before an unfinished probe is reported
+#define REFRESH_DELAY     500      // milliseconds of quiet after a device change
+
+// Region of memory handed out front to back and never freed
+typedef struct {
+	BYTE* base;
+	SIZE_T size;
+	SIZE_T used;
+} ARENA;
+
+// Fixed size blocks carved out of an arena
+typedef struct {
+	SLIST_HEADER freeBlocks;
+	SIZE_T blockSize;
+} POOL;
+
+// Data waiting to be written to the port
+typedef struct WRITENODE {
+	struct WRITENODE* next;
+	DWORD length;
+	char data[WRITE_NODE_SIZE];
+} WRITENODE;
+
+// Nodes waiting for a writer thread to write them to a port
+typedef struct {
+	CRITICAL_SECTION lock;    // guards the rest
+	HANDLE port;              // where the nodes are written
+	HANDLE thread;            // writer thread, NULL when not running
+	HANDLE queued;            // signalled when nodes are queued
+	HANDLE drained;           // signalled when the writer frees nodes
+	POOL* pool;               // where the nodes come from
+	BOOL stopping;
+	WRITENODE* head;          // oldest queued node
+	WRITENODE* tail;
+} WRITEQUEUE;
+
+// How the read thread treats received bytes as packets
+typedef enum {
+	FRAMING_OFF,      // printed as characters
+	FRAMING_COBS,     // COBS packets ended by 0x00
+	FRAMING_SLIP      // SLIP packets ended by END
+} FRAMING;
+
+// A keystroke drawn ahead of its echo
+typedef struct {
+	char ch;          // character sent to the port
+	DWORD epoch;      // prediction epoch the keystroke belongs to
+	DWORD sentTime;   // tick count when the keystroke was sent
+	BOOL shown;       // drawn on screen as tentative
+	int column;       // column of the cursor's line it was drawn at
+} PREDICTION;
 
 // Global variables
 extern HANDLE hComm;         // handle for communication port
@@ -50,6 +136,18 @@ extern DWORD readThreadID;
 extern LPCSTR lpszCommName;  // COM port name
 extern DCB dcb;
 extern HDC hdc;
+extern BOOL predictEnabled;  // flag to signal if predictive local echo is on
+extern ARENA sessionArena;   // session data, allocated once at startup
+extern POOL rxPool;          // receive buffers
+extern POOL writePool;       // write queue nodes
+extern WRITEQUEUE terminalWriter; // writes to hComm
+extern BOOL analyzerEnabled; // flag to signal if the read thread timestamps bytes
+extern FRAMING framingMode;  // packet framing of the read thread
+extern BOOL autoBaudEnabled; // flag to signal if probes look for the baud rate
+extern DWORD detectedBaud;   // baud rate lpszCommName answered at, 0 if unknown
+extern CRITICAL_SECTION screenLock; // guards the scrollback and predictions
+extern COLORREF backgroundColor;
+extern COLORREF textColor;
 
 // Function prototypes
 void Connect();
@@ -57,8 +155,53 @@ void Disconnect();
 BOOL GetCommParameters();
 DWORD WINAPI MonitorInputThread(LPVOID hwnd);
 void WriteToSerial(WPARAM wParam);
-void PrintToScreen(char readBuffer[]);
+void InitWriteQueue(WRITEQUEUE* queue, POOL* pool);
+BOOL QueueWrite(WRITEQUEUE* queue, const char* data, DWORD length);
+BOOL StartWriter(WRITEQUEUE* queue, HANDLE port);
+void StopWriter(WRITEQUEUE* queue);
+BOOL OpenCommPort(LPCSTR name, HANDLE* port, DCB* settings, LPCSTR* error);
+int RunBridge(LPSTR args);
+void InitMemory();
+void* ArenaAlloc(ARENA* arena, SIZE_T size);
+BOOL PoolInit(POOL* pool, ARENA* arena, SIZE_T blockSize, DWORD count);
+void* PoolAlloc(POOL* pool);
+void PoolFree(POOL* pool, void* block);
+void CheckSteadyState(DWORD receivedBytes);
+void PrintToScreen(char readBuffer[], DWORD length);
+void PrintListing(char text[], DWORD length);
+void InitAnalyzer();
+void PrintTimeline();
+LONGLONG TicksToMicros(LONGLONG ticks);
+DWORD AnalyzeInput();
+void ShowGapHistogram();
+void InitFraming();
+void StartFraming();
+void FrameInput(char data[], DWORD length);
+void FrameKeystroke(char c);
+void SetFraming(FRAMING mode);
+void DiscoverPorts(BOOL reprobe);
+void PortProbed(LPARAM probe);
+void ProbesTimedOut();
+void SelectPort(int index);
+void BuildPortMenu();
+BOOL CheckPortIdle(LPCSTR name);
 void SetConnectedUI();
 void SetDisconnectedUI();
+void InitScreen();
+void ScreenPutChar(char c);
+void ResizeScreen(int width, int height);
+void ScrollScreen(int rows);
+void ScrollScreenTo(int line);
+void UpdateScrollBar();
+void PaintScreen(HDC hdcPaint);
+void DrawPrediction(PREDICTION* p, const PREDICTION* last);
+void ErasePrediction(const PREDICTION* p);
+void SetPrediction(BOOL enable);
+void PredictKeystroke(char c);
+void ConfirmPrediction(char c);
+void RevealPredictions();
+void ExpirePredictions();
+int GetPredictionCount();
+const PREDICTION* GetPrediction(int i);
 
 #endif